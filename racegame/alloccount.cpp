@@ -0,0 +1,35 @@
+#include "alloccount.h"
+#include <cstdlib>
+#include <new>
+
+// every other form of new and delete forwards to these four
+
+void *operator new(size_t size) {
+	allocationCounter().fetch_add(1, std::memory_order_relaxed);
+
+	void *p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+	free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	free(p);
+}
+
+// the sized deletes c++14 calls, replaced along with the rest so -Wsized-deallocation stays quiet
+void operator delete(void *p, size_t) noexcept {
+	operator delete(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+	operator delete[](p);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// counts heap allocations - global operator new is replaced in alloccount.cpp, so taking
+// the count before and after a piece of code shows whether it touched the heap. only the
+// game and racebench link alloccount.cpp - a library loaded into someone else's process
+// (racegym) mustn't swap out its allocator, and there the count just stays at 0
+
+#include <atomic>
+#include <cstddef>
+
+inline std::atomic<size_t> &allocationCounter() {
+	static std::atomic<size_t> allocations(0);
+	return allocations;
+}
+
+// total allocations made through operator new since the program started
+inline size_t allocationCount() {
+	return allocationCounter().load(std::memory_order_relaxed);
+}
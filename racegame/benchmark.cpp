@@ -0,0 +1,265 @@
+#include "benchmark.h"
+#include "collision.h"
+#include "simulation.h"
+#include "track.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+
+std::vector<edge> ringTrack(int segments, float &radius) {
+	int perWall = segments / 2;
+	radius = perWall * 2.0f / (2 * 3.14159265359f);
+
+	std::vector<edge> edges;
+	for (int wall = 0; wall < 2; wall++) {
+		// outer and inner walls, 6 units either side of the centre of the road
+		float r = radius + (wall == 0 ? 6.0f : -6.0f);
+		for (int i = 0; i < perWall; i++) {
+			float a1 = 2 * 3.14159265359f * i / perWall;
+			float a2 = 2 * 3.14159265359f * (i + 1) / perWall;
+			point p1 = { r * cosf(a1), r * sinf(a1) };
+			point p2 = { r * cosf(a2), r * sinf(a2) };
+			edges.push_back({ p1, p2 });
+		}
+	}
+	return edges;
+}
+
+std::vector<CarEdges> queryCars(int count, float radius) {
+	CarPool pool;
+	for (int i = 0; i < count; i++) {
+		float a = 2 * 3.14159265359f * i / count;
+		float r = radius + 6.0f * sin(i * 0.37f);	// wanders from wall to wall
+		int car = pool.add(r * cos(a), r * sin(a), false);
+
+		// face somewhere between along the road and into the wall
+		float heading = a + 0.8f * sin(i * 1.3f);
+		pool.vel_x[car] = -sin(heading);
+		pool.vel_y[car] = cos(heading);
+	}
+
+	std::vector<CarEdges> boxes;
+	for (int i = 0; i < count; i++)
+		boxes.push_back(pool.edges(i));
+	return boxes;
+}
+
+void writeRingTrack(const std::string &path, const std::vector<edge> &edges, float radius) {
+	std::ofstream out(path.c_str());
+	out << std::setprecision(9);
+	for (size_t i = 0; i < edges.size(); i++)
+		out << "wall " << edges[i].p1.x << " " << edges[i].p1.y << " " << edges[i].p2.x << " " << edges[i].p2.y << "\n";
+	out << "start " << radius - 6 << " 0 " << radius + 6 << " 0\n";
+	for (int i = 0; i < 8; i++)
+		out << "waypoint " << radius * cos(i * 3.14159265359f / 4) << " " << radius * sin(i * 3.14159265359f / 4) << "\n";
+}
+
+int runTrackBenchmark() {
+	const int queries = 20000;
+	const std::string sourcePath = "bench_ring.track", compiledPath = "bench_ring.trk";
+
+	std::cout << std::setw(10) << "segments" << std::setw(16) << "grid ns/query" << std::setw(17) << "brute ns/query" << std::setw(8) << "hits"
+		<< std::setw(13) << "compile ms" << std::setw(10) << "load us" << std::endl;
+
+	for (int segments = 16; segments <= 262144; segments *= 4) {
+		float radius;
+		std::vector<edge> edges = ringTrack(segments, radius);
+		std::vector<CarEdges> boxes = queryCars(1000, radius);
+
+		TrackGrid grid;
+		grid.build(edges);
+
+		// grid
+		int gridHits = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < queries; i++)
+			gridHits += grid.isColliding(boxes[i % boxes.size()]);
+		std::chrono::duration<double, std::nano> gridTime = std::chrono::steady_clock::now() - start;
+
+		// brute force, fewer queries on the big tracks so it finishes
+		int bruteQueries = std::max(100, queries * 16 / segments);
+		volatile int bruteHits = 0;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < bruteQueries; i++)
+			bruteHits += isColliding(boxes[i % boxes.size()], edges);
+		std::chrono::duration<double, std::nano> bruteTime = std::chrono::steady_clock::now() - start;
+
+		// both must agree on which cars hit a wall
+		for (int i = 0; i < bruteQueries; i++) {
+			const CarEdges &box = boxes[i % boxes.size()];
+			if (grid.isColliding(box) != isColliding(box, edges)) {
+				std::cout << "grid and brute force disagree at " << edges.size() << " segments" << std::endl;
+				return 1;
+			}
+		}
+
+		// compiling the text does all the work, loading the compiled file should take the
+		// same time at any size - and the loaded grid has to give the same answers
+		writeRingTrack(sourcePath, edges, radius);
+		std::string error;
+		Track compiled, loaded;
+		start = std::chrono::steady_clock::now();
+		bool ok = compiled.compile(sourcePath, error) && compiled.save(compiledPath);
+		std::chrono::duration<double, std::milli> compileTime = std::chrono::steady_clock::now() - start;
+
+		start = std::chrono::steady_clock::now();
+		ok = ok && loaded.loadCompiled(compiledPath, error);
+		std::chrono::duration<double, std::micro> loadTime = std::chrono::steady_clock::now() - start;
+
+		for (size_t i = 0; ok && i < boxes.size(); i++)
+			ok = loaded.grid().isColliding(boxes[i]) == grid.isColliding(boxes[i]);
+
+		remove(sourcePath.c_str());
+		remove(compiledPath.c_str());
+		if (!ok) {
+			std::cout << "compiled track doesn't match at " << edges.size() << " segments " << error << std::endl;
+			return 1;
+		}
+
+		std::cout << std::setw(10) << edges.size()
+			<< std::setw(16) << std::fixed << std::setprecision(1) << gridTime.count() / queries
+			<< std::setw(17) << bruteTime.count() / bruteQueries
+			<< std::setw(8) << gridHits
+			<< std::setw(13) << compileTime.count()
+			<< std::setw(10) << loadTime.count() << std::endl;
+	}
+
+	return 0;
+}
+
+int runWallBenchmark() {
+	const int queries = 200000;
+
+	std::cout << std::setw(10) << "segments" << std::setw(16) << "grid ns/query" << std::setw(15) << "sdf ns/query"
+		<< std::setw(11) << "grid hits" << std::setw(10) << "sdf hits" << std::setw(10) << "disagree"
+		<< std::setw(11) << "build ms" << std::setw(11) << "sdf KB" << std::endl;
+
+	for (int segments = 16; segments <= 65536; segments *= 4) {
+		float radius;
+		std::vector<edge> edges = ringTrack(segments, radius);
+		std::vector<CarEdges> boxes = queryCars(1000, radius);
+
+		TrackGrid grid;
+		grid.build(edges);
+
+		auto start = std::chrono::steady_clock::now();
+		DistanceField field;
+		field.build(edges);
+		std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+
+		// segment tests through the grid
+		volatile int gridHits = 0;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < queries; i++)
+			gridHits += grid.isColliding(boxes[i % boxes.size()]);
+		std::chrono::duration<double, std::nano> gridTime = std::chrono::steady_clock::now() - start;
+
+		// six lookups, the corners and the middles of the long sides, with the segment test
+		// for boxes right by a wall
+		volatile int fieldHits = 0;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < queries; i++)
+			fieldHits += field.isColliding(boxes[i % boxes.size()], grid);
+		std::chrono::duration<double, std::nano> fieldTime = std::chrono::steady_clock::now() - start;
+
+		// the field falls back on the segment test near a wall, so it catches everything
+		// that does - it only disagrees over a box sitting right over a wall, which the
+		// field catches and the segment test, with no side crossing one, doesn't
+		int disagree = 0;
+		for (size_t i = 0; i < boxes.size(); i++)
+			disagree += grid.isColliding(boxes[i]) != field.isColliding(boxes[i], grid);
+
+		std::cout << std::setw(10) << edges.size()
+			<< std::setw(16) << std::fixed << std::setprecision(1) << gridTime.count() / queries
+			<< std::setw(15) << fieldTime.count() / queries
+			<< std::setw(11) << gridHits / (queries / boxes.size())
+			<< std::setw(10) << fieldHits / (queries / boxes.size())
+			<< std::setw(10) << disagree
+			<< std::setw(11) << buildTime.count()
+			<< std::setw(11) << (field.storedSamples().size() * sizeof(float) + field.slots().size() * sizeof(TileSlot)) / 1024
+			<< std::endl;
+	}
+
+	return 0;
+}
+
+// segments that need the exact handling - parallel, collinear, touching and zero length
+static std::vector<edge> awkwardSegments() {
+	std::vector<edge> edges;
+	edges.push_back({ { 0, 0 }, { 2, 0 } });		// horizontal
+	edges.push_back({ { 0, 1 }, { 2, 1 } });		// parallel to it, apart
+	edges.push_back({ { 1, 0 }, { 3, 0 } });		// collinear, overlapping
+	edges.push_back({ { 3, 0 }, { 4, 0 } });		// collinear, apart
+	edges.push_back({ { 2, 0 }, { 2, 2 } });		// touches at an end
+	edges.push_back({ { 1, 0 }, { 1, 0 } });		// a point on the first
+	edges.push_back({ { 1, 1 }, { 1, 1 } });		// a point off it
+	edges.push_back({ { 0, 0 }, { 2, 0 } });		// identical
+	edges.push_back({ { -1, -1 }, { 3, 3 } });		// diagonal through the lot
+	edges.push_back({ { 0, 0 }, { 0, 0 } });		// a point on an end
+	return edges;
+}
+
+int runCollisionBenchmark() {
+	// random segments around a small area, so about half of the pairs cross
+	srand(1);
+	std::vector<edge> segments;
+	for (int i = 0; i < 4096; i++) {
+		point p1 = { rand() % 1000 / 100.0f, rand() % 1000 / 100.0f };
+		point p2 = { p1.x + (rand() % 600 - 300) / 100.0f, p1.y + (rand() % 600 - 300) / 100.0f };
+		segments.push_back({ p1, p2 });
+	}
+	std::vector<edge> awkward = awkwardSegments();
+
+	CollisionKernel original = collisionKernel();
+	CollisionKernel kernels[] = { KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX };
+
+	std::cout << "dispatch picked " << collisionKernelName(original) << std::endl;
+
+	for (CollisionKernel kernel : kernels) {
+		if (!setCollisionKernel(kernel)) {
+			std::cout << std::setw(8) << collisionKernelName(kernel) << "  not supported on this cpu" << std::endl;
+			continue;
+		}
+
+		// every single pair must give the same answer as the scalar test
+		for (size_t i = 0; i < awkward.size(); i++) {
+			for (size_t j = 0; j < awkward.size(); j++) {
+				if (edgesHitSegments(awkward[i], &awkward[j], 1) != segmentsIntersect(awkward[i], awkward[j])) {
+					std::cout << collisionKernelName(kernel) << " disagrees on awkward pair " << i << ", " << j << std::endl;
+					return 1;
+				}
+			}
+		}
+		for (size_t i = 0; i + 1 < segments.size(); i += 2) {
+			if (edgesHitSegments(segments[i], &segments[i + 1], 1) != segmentsIntersect(segments[i], segments[i + 1])) {
+				std::cout << collisionKernelName(kernel) << " disagrees on random pair " << i << std::endl;
+				return 1;
+			}
+		}
+
+		// time car sized probes of four edges against blocks of 16 segments, roughly what a
+		// grid cell holds, with a probe that never hits so every pair gets tested
+		CarEdges probe = { { { { 100, 100 }, { 100, 101 } }, { { 100, 101 }, { 101, 101 } },
+			{ { 101, 101 }, { 101, 100 } }, { { 101, 100 }, { 100, 100 } } } };
+		const int block = 16;
+		const int rounds = 200;
+		volatile int hits = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < rounds; r++) {
+			for (size_t j = 0; j + block <= segments.size(); j += block)
+				hits += edgesHitSegments(probe, &segments[j], block);
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		double pairs = 4.0 * rounds * (segments.size() / block * block);
+
+		std::cout << std::setw(8) << collisionKernelName(kernel) << std::setw(12) << std::fixed << std::setprecision(1)
+			<< pairs / elapsed.count() / 1e6 << " million pairs/sec" << std::endl;
+	}
+
+	setCollisionKernel(original);
+	return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// timing runs for the simulation code, selected from the command line - each returns the process exit code
+
+#include <string>
+#include <vector>
+#include "geometry.h"
+
+// times a car-vs-track collision query against tracks of growing segment counts,
+// comparing the grid against testing every edge
+int runTrackBenchmark();
+
+// times the car-vs-wall test both ways - segment tests through the grid, and looking up
+// the box's corners and sides in the distance field - and counts the cars they disagree about
+int runWallBenchmark();
+
+// checks every collision kernel this cpu supports agrees with segmentsIntersect, including
+// parallel and zero length segments, then times segment pair tests per second for each
+int runCollisionBenchmark();
+
+// the scenes the runs above time, which the racebench suite reuses
+
+// builds a ring shaped circuit with the given number of wall segments, each about two
+// units long, so the track gets bigger (not denser) as the segment count grows
+std::vector<edge> ringTrack(int segments, float &radius);
+
+// car boxes spread along the road of a ring, some touching the walls
+std::vector<CarEdges> queryCars(int count, float radius);
+
+// writes a ring as a text track, with a start line across the road and waypoints round it
+void writeRingTrack(const std::string &path, const std::vector<edge> &edges, float radius);
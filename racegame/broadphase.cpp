@@ -0,0 +1,85 @@
+#include "broadphase.h"
+#include "collision.h"
+#include "simulation.h"
+#include <algorithm>
+#include <cmath>
+
+void CarBroadPhase::update(const CarPool &cars) {
+	size_t n = cars.size();
+
+	// cars added or removed since last time - start the order again
+	if (order.size() != n) {
+		order.resize(n);
+		for (size_t i = 0; i < n; i++)
+			order[i] = (int)i;
+
+		// room for every car to be touching a few others without growing mid-race
+		colliding.reserve(n * 4);
+	}
+
+	min_x.resize(n);
+	max_x.resize(n);
+	min_y.resize(n);
+	max_y.resize(n);
+
+	// box half sizes come from the heading, the same axes the edges are built from. the
+	// centres' spread on each axis picks the one to sweep along
+	double sum_x = 0, sum_y = 0, square_x = 0, square_y = 0;
+	for (size_t i = 0; i < n; i++) {
+		float ext_x = fabs(cars.vel_x[i] * carLengthHalf) + fabs(cars.vel_y[i] * carWidthHalf);
+		float ext_y = fabs(cars.vel_y[i] * carLengthHalf) + fabs(cars.vel_x[i] * carWidthHalf);
+		min_x[i] = cars.pos_x[i] - ext_x;
+		max_x[i] = cars.pos_x[i] + ext_x;
+		min_y[i] = cars.pos_y[i] - ext_y;
+		max_y[i] = cars.pos_y[i] + ext_y;
+
+		sum_x += cars.pos_x[i];
+		sum_y += cars.pos_y[i];
+		square_x += (double)cars.pos_x[i] * cars.pos_x[i];
+		square_y += (double)cars.pos_y[i] * cars.pos_y[i];
+	}
+
+	// n times each variance - the same scale for both, which is all the comparison needs
+	double spread_x = square_x - sum_x * sum_x / (n > 0 ? n : 1);
+	double spread_y = square_y - sum_y * sum_y / (n > 0 ? n : 1);
+	bool alongY = spread_y > spread_x;
+	const std::vector<float> &low = alongY ? min_y : min_x, &high = alongY ? max_y : max_x;
+	const std::vector<float> &otherLow = alongY ? min_x : min_y, &otherHigh = alongY ? max_x : max_y;
+
+	if (alongY != sweepY) {
+		std::sort(order.begin(), order.end(), [&low](int a, int b) { return low[a] < low[b]; });
+		sweepY = alongY;
+	}
+
+	// insertion sort on the low side of each box
+	for (size_t i = 1; i < n; i++) {
+		int car = order[i];
+		float key = low[car];
+		size_t j = i;
+		while (j > 0 && low[order[j - 1]] > key) {
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = car;
+	}
+
+	// sweep - each car only needs checking against the cars that start before it ends
+	colliding.clear();
+	candidateCount = 0;
+	edgeTestCount = 0;
+	for (size_t i = 0; i < n; i++) {
+		int a = order[i];
+
+		for (size_t j = i + 1; j < n && low[order[j]] <= high[a]; j++) {
+			int b = order[j];
+
+			candidateCount++;
+			if (otherLow[b] > otherHigh[a] || otherHigh[b] < otherLow[a])
+				continue;
+
+			edgeTestCount++;
+			if (isColliding(cars.edges(a), cars.edges(b)))
+				colliding.push_back({ a, b });
+		}
+	}
+}
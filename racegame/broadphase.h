@@ -0,0 +1,43 @@
+#pragma once
+
+// car-vs-car collision for any number of cars - a sweep and prune broad phase finds
+// cars whose bounding boxes overlap, and only those pairs get the edge test. the sweep
+// runs along whichever axis the cars are spread wider on that update, so a field strung
+// out along a straight overlaps as little as it can
+
+#include <vector>
+#include <cstddef>
+#include "carpool.h"
+
+struct CarPair {
+	int a, b;
+};
+
+class CarBroadPhase {
+public:
+	// finds every pair of cars whose edges cross, results are left in pairs()
+	void update(const CarPool &cars);
+
+	const std::vector<CarPair> &pairs() const { return colliding; }
+
+	// how many pairs the sweep found overlapping along its axis last update - the work the
+	// broad phase did, before the other axis turned some of them away
+	size_t candidates() const { return candidateCount; }
+
+	// how many of those overlapped on both axes and got the edge test
+	size_t edgeTests() const { return edgeTestCount; }
+
+private:
+	// cars sorted by the low side of their bounding box along the sweep axis - kept between
+	// updates, since cars barely move in one tick the insertion sort that fixes it up is
+	// close to linear. a new axis sorts it afresh
+	std::vector<int> order;
+	bool sweepY = false;
+
+	// axis aligned bounding box of each car, indexed by car
+	std::vector<float> min_x, max_x, min_y, max_y;
+
+	std::vector<CarPair> colliding;
+	size_t candidateCount = 0;
+	size_t edgeTestCount = 0;
+};
@@ -0,0 +1,216 @@
+#include "carpool.h"
+#include "simulation.h"
+#include "simd.h"
+#include <cmath>
+#include <cstring>
+
+int CarPool::add(float x, float y, bool humanPlayer) {
+	pos_x.push_back(x);
+	pos_y.push_back(y);
+	rot.push_back(0.0f);
+	speed.push_back(0.0f);
+	vel_x.push_back(0.0f);	// rot 0 faces straight up the y axis
+	vel_y.push_back(1.0f);
+	prev_x.push_back(x);
+	prev_y.push_back(y);
+	prev_rot.push_back(0.0f);
+	prev_vel_x.push_back(0.0f);
+	prev_vel_y.push_back(1.0f);
+	controls.push_back(0);
+	playerControlled.push_back(humanPlayer);
+	nextWaypoint.push_back(0);
+
+	// NaN never compares equal, so the first edges() call builds the box
+	CachedBox box;
+	box.x = NAN;
+	boxes.push_back(box);
+
+	return (int)pos_x.size() - 1;
+}
+
+void CarPool::clear() {
+	pos_x.clear();
+	pos_y.clear();
+	rot.clear();
+	speed.clear();
+	vel_x.clear();
+	vel_y.clear();
+	prev_x.clear();
+	prev_y.clear();
+	prev_rot.clear();
+	prev_vel_x.clear();
+	prev_vel_y.clear();
+	controls.clear();
+	playerControlled.clear();
+	nextWaypoint.clear();
+	boxes.clear();
+}
+
+// the heading is a unit vector, so the box axes come straight from it without any trig:
+// forward is (vel_x, vel_y) and right is (vel_y, -vel_x)
+void carEdgesAt(float x, float y, float vx, float vy, CarEdges &edges) {
+	float fx = vx * carLengthHalf, fy = vy * carLengthHalf;
+	float rx = vy * carWidthHalf, ry = -vx * carWidthHalf;
+
+	point tl = { x + fx - rx, y + fy - ry };
+	point tr = { x + fx + rx, y + fy + ry };
+	point bl = { x - fx - rx, y - fy - ry };
+	point br = { x - fx + rx, y - fy + ry };
+
+	edges[0] = { tl, bl }; // left
+	edges[1] = { tl, tr }; // top
+	edges[2] = { tr, br }; // right
+	edges[3] = { br, bl }; // bottom
+}
+
+const CarEdges &CarPool::edges(int car) const {
+	CachedBox &box = boxes[car];
+	float x = pos_x[car], y = pos_y[car];
+	float vx = vel_x[car], vy = vel_y[car];
+
+	if (box.x == x && box.y == y && box.vel_x == vx && box.vel_y == vy)
+		return box.edges;
+
+	carEdgesAt(x, y, vx, vy, box.edges);
+	box.x = x;
+	box.y = y;
+	box.vel_x = vx;
+	box.vel_y = vy;
+	return box.edges;
+}
+
+// turning only ever changes rot by +/- rotRate, so rather than calling sin/cos for
+// every car each tick the heading is rotated by a fixed matrix, then pulled back to
+// unit length with one newton step so rounding can't build up over a long race
+void updateCars(CarPool &cars, const CarTuning &tuning) {
+	size_t n = cars.size();
+	const float maxSpeed = tuning.maxSpeed, accelRate = tuning.accelRate;
+	const float decelRate = tuning.decelRate, rotRate = tuning.rotRate;
+	float turnCos = cos(rotRate * piOver180);
+	float turnSin = sin(rotRate * piOver180);
+
+	float *pos_x = cars.pos_x.data(), *pos_y = cars.pos_y.data();
+	float *rot = cars.rot.data(), *speed = cars.speed.data();
+	float *vel_x = cars.vel_x.data(), *vel_y = cars.vel_y.data();
+	float *prev_x = cars.prev_x.data(), *prev_y = cars.prev_y.data();
+	float *prev_rot = cars.prev_rot.data();
+	float *prev_vel_x = cars.prev_vel_x.data(), *prev_vel_y = cars.prev_vel_y.data();
+	unsigned char *controls = cars.controls.data();
+
+	size_t i = 0;
+
+#ifdef RACEGAME_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 threeHalves = _mm_set1_ps(1.5f);
+	const __m128 decel = _mm_set1_ps(decelRate);
+	const __m128 accel = _mm_set1_ps(accelRate);
+	const __m128 top = _mm_set1_ps(maxSpeed);
+	const __m128 turnStep = _mm_set1_ps(rotRate);
+	const __m128 cosStep = _mm_set1_ps(turnCos);
+	const __m128 sinStep = _mm_set1_ps(turnSin);
+	const __m128 fullTurn = _mm_set1_ps(360.0f);
+	const __m128 minusFullTurn = _mm_set1_ps(-360.0f);
+	const __m128i accelBit = _mm_set1_epi32(CONTROL_ACCELERATE);
+	const __m128i leftBit = _mm_set1_epi32(CONTROL_LEFT);
+	const __m128i rightBit = _mm_set1_epi32(CONTROL_RIGHT);
+	const __m128i zeroi = _mm_setzero_si128();
+
+	for (; i + 4 <= n; i += 4) {
+		// widen four control bytes out to one 32 bit lane each
+		int packed;
+		memcpy(&packed, controls + i, sizeof(packed));
+		__m128i c = _mm_cvtsi32_si128(packed);
+		c = _mm_unpacklo_epi16(_mm_unpacklo_epi8(c, zeroi), zeroi);
+		__m128 isAccelerating = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(c, accelBit), accelBit));
+		__m128 isLeft = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(c, leftBit), leftBit));
+		__m128 isRight = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(c, rightBit), rightBit));
+
+		// deceleration, never below 0
+		__m128 s = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(speed + i), decel), zero);
+
+		// acceleration, up to maxSpeed
+		__m128 canAccelerate = _mm_and_ps(isAccelerating, _mm_cmplt_ps(s, top));
+		s = _mm_add_ps(s, _mm_and_ps(canAccelerate, accel));
+
+		// turning: +1 for left, -1 for right, 0 for both or neither
+		__m128 turn = _mm_sub_ps(_mm_and_ps(isLeft, one), _mm_and_ps(isRight, one));
+		__m128 r0 = _mm_loadu_ps(rot + i);
+		__m128 r = _mm_add_ps(r0, _mm_mul_ps(turn, turnStep));
+		r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, fullTurn), fullTurn));
+		r = _mm_add_ps(r, _mm_and_ps(_mm_cmplt_ps(r, minusFullTurn), fullTurn));
+
+		// rotate heading by the turn
+		__m128 turning = _mm_cmpneq_ps(turn, zero);
+		__m128 cs = _mm_or_ps(_mm_and_ps(turning, cosStep), _mm_andnot_ps(turning, one));
+		__m128 sn = _mm_mul_ps(turn, sinStep);
+		__m128 vx = _mm_loadu_ps(vel_x + i), vy = _mm_loadu_ps(vel_y + i);
+		__m128 nvx = _mm_sub_ps(_mm_mul_ps(vx, cs), _mm_mul_ps(vy, sn));
+		__m128 nvy = _mm_add_ps(_mm_mul_ps(vx, sn), _mm_mul_ps(vy, cs));
+		__m128 len2 = _mm_add_ps(_mm_mul_ps(nvx, nvx), _mm_mul_ps(nvy, nvy));
+		__m128 k = _mm_sub_ps(threeHalves, _mm_mul_ps(half, len2));
+		nvx = _mm_mul_ps(nvx, k);
+		nvy = _mm_mul_ps(nvy, k);
+
+		// move, keeping the old pose so collisions can undo it
+		__m128 px = _mm_loadu_ps(pos_x + i), py = _mm_loadu_ps(pos_y + i);
+		_mm_storeu_ps(prev_x + i, px);
+		_mm_storeu_ps(prev_y + i, py);
+		_mm_storeu_ps(prev_rot + i, r0);
+		_mm_storeu_ps(prev_vel_x + i, vx);
+		_mm_storeu_ps(prev_vel_y + i, vy);
+		_mm_storeu_ps(pos_x + i, _mm_add_ps(px, _mm_mul_ps(s, nvx)));
+		_mm_storeu_ps(pos_y + i, _mm_add_ps(py, _mm_mul_ps(s, nvy)));
+
+		_mm_storeu_ps(speed + i, s);
+		_mm_storeu_ps(rot + i, r);
+		_mm_storeu_ps(vel_x + i, nvx);
+		_mm_storeu_ps(vel_y + i, nvy);
+
+		// controls have been consumed
+		memset(controls + i, 0, 4);
+	}
+#endif
+
+	// scalar path, for the tail and for compilers without SSE2 - same maths as above
+	for (; i < n; i++) {
+		unsigned char c = controls[i];
+
+		float s = speed[i] - decelRate;
+		if (s < 0)
+			s = 0;
+
+		if ((c & CONTROL_ACCELERATE) && s < maxSpeed)
+			s += accelRate;
+
+		float turn = ((c & CONTROL_LEFT) ? 1.0f : 0.0f) - ((c & CONTROL_RIGHT) ? 1.0f : 0.0f);
+		float r = rot[i] + turn * rotRate;
+		if (r > 360)
+			r -= 360;
+		if (r < -360)
+			r += 360;
+
+		float cs = turn != 0 ? turnCos : 1.0f;
+		float sn = turn * turnSin;
+		float vx = vel_x[i] * cs - vel_y[i] * sn;
+		float vy = vel_x[i] * sn + vel_y[i] * cs;
+		float k = 1.5f - 0.5f * (vx * vx + vy * vy);
+		vx *= k;
+		vy *= k;
+
+		prev_x[i] = pos_x[i];
+		prev_y[i] = pos_y[i];
+		prev_rot[i] = rot[i];
+		prev_vel_x[i] = vel_x[i];
+		prev_vel_y[i] = vel_y[i];
+		pos_x[i] += s * vx;
+		pos_y[i] += s * vy;
+
+		speed[i] = s;
+		rot[i] = r;
+		vel_x[i] = vx;
+		vel_y[i] = vy;
+		controls[i] = 0;
+	}
+}
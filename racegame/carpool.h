@@ -0,0 +1,67 @@
+#pragma once
+
+// car storage - every car's state is kept structure-of-arrays, one contiguous
+// array per field, so the per-tick update can stream through thousands of cars
+
+#include <vector>
+#include <cstddef>
+#include "geometry.h"
+
+// control bits for each car, set by the keyboard or the AI and consumed by updateCars()
+const unsigned char CONTROL_ACCELERATE = 1;
+const unsigned char CONTROL_BRAKE = 2;
+const unsigned char CONTROL_LEFT = 4;
+const unsigned char CONTROL_RIGHT = 8;
+
+// the handling numbers every car in a race shares - the tournament races variations of
+// these against each other to tune them
+struct CarTuning {
+	float maxSpeed = 0.014f;
+	float accelRate = 0.00009f;
+	float decelRate = 0.000009f;
+	float rotRate = 0.2f;		// degrees per tick
+};
+
+struct CarPool {
+	std::vector<float> pos_x;		// stores the CENTRE POINT of each car
+	std::vector<float> pos_y;
+	std::vector<float> rot;			// rotation in degrees
+	std::vector<float> speed;		// overall speed
+	std::vector<float> vel_x;		// unit heading, rotated along with rot
+	std::vector<float> vel_y;
+	std::vector<float> prev_x;		// position before this tick's move, restored on collision
+	std::vector<float> prev_y;
+	std::vector<float> prev_rot;	// and heading, so turning can't leave a car stuck inside something
+	std::vector<float> prev_vel_x;
+	std::vector<float> prev_vel_y;
+	std::vector<unsigned char> controls;			// CONTROL_ bits for this tick
+	std::vector<unsigned char> playerControlled;	// whether cpu controlled
+	std::vector<int> nextWaypoint;					// the waypoint cpu cars will seek
+
+	// adds a car facing up the track, returns its index
+	int add(float x, float y, bool humanPlayer);
+
+	void clear();
+
+	size_t size() const { return pos_x.size(); }
+
+	// returns the edges of a car's oriented bounding box - cached, and only worked out
+	// again when the car has moved or turned since the last call
+	const CarEdges &edges(int car) const;
+
+private:
+	// a box along with the pose it was built for
+	struct CachedBox {
+		float x, y, vel_x, vel_y;
+		CarEdges edges;
+	};
+
+	mutable std::vector<CachedBox> boxes;
+};
+
+// the box of a car centred on (x, y) and heading along the unit vector (vx, vy)
+void carEdgesAt(float x, float y, float vx, float vy, CarEdges &edges);
+
+// one fused pass over every car: deceleration, acceleration, turning, velocity and
+// movement, then clears the controls ready for the next tick
+void updateCars(CarPool &cars, const CarTuning &tuning);
@@ -0,0 +1,151 @@
+#include "centreline.h"
+#include <algorithm>
+#include <cmath>
+
+void Centreline::build(ArrayView<point> waypoints, const edge &startLine, EdgeSpan sectorLines) {
+	segments.clear();
+	sectors.clear();
+	lapLength = 0.0f;
+	startAlong = 0.0f;
+	if (waypoints.size() < 3)
+		return;
+
+	// a waypoint repeating the one before it is left out - project() could never step off
+	// a segment with no length, so a car's distance round would stop there
+	for (size_t i = 0; i < waypoints.size(); i++) {
+		const point &a = waypoints[i], &b = waypoints[(i + 1) % waypoints.size()];
+		float dx = b.x - a.x, dy = b.y - a.y;
+		float length = sqrt(dx * dx + dy * dy);
+		if (!(length > 0))
+			continue;
+		Segment s = { a, dx / length, dy / length, length, lapLength };
+		segments.push_back(s);
+		lapLength += length;
+	}
+	if (segments.size() < 3) {
+		segments.clear();
+		lapLength = 0.0f;
+		return;
+	}
+
+	startAlong = crossing(startLine);
+	for (size_t i = 0; i < sectorLines.size(); i++)
+		sectors.push_back(fromStart(crossing(sectorLines[i])));
+	std::sort(sectors.begin(), sectors.end());
+}
+
+float Centreline::alongSegment(const Segment &s, float x, float y) const {
+	return (x - s.from.x) * s.dir_x + (y - s.from.y) * s.dir_y;
+}
+
+float Centreline::fromStart(float along) const {
+	float distance = along - startAlong;
+	if (distance < 0)
+		distance += lapLength;
+	if (distance >= lapLength)
+		distance -= lapLength;
+	return distance;
+}
+
+float Centreline::crossing(const edge &line) const {
+	float sx = line.p2.x - line.p1.x, sy = line.p2.y - line.p1.y;
+	for (size_t i = 0; i < segments.size(); i++) {
+		const Segment &s = segments[i];
+		edge e = { s.from, { s.from.x + s.dir_x * s.length, s.from.y + s.dir_y * s.length } };
+		if (s.length <= 0 || !segmentsIntersect(e, line))
+			continue;
+
+		// where along the segment the two lines meet - parallel ones just take its start
+		float denominator = s.dir_x * sy - s.dir_y * sx;
+		float t = 0.0f;
+		if (denominator != 0)
+			t = ((line.p1.x - s.from.x) * sy - (line.p1.y - s.from.y) * sx) / denominator;
+		return s.along + std::min(std::max(t, 0.0f), s.length);
+	}
+
+	point middle = { (line.p1.x + line.p2.x) * 0.5f, (line.p1.y + line.p2.y) * 0.5f };
+	const Segment &s = segments[nearestSegment(middle.x, middle.y)];
+	return s.along + std::min(std::max(alongSegment(s, middle.x, middle.y), 0.0f), s.length);
+}
+
+int Centreline::nearestSegment(float x, float y) const {
+	int nearest = 0;
+	float best = INFINITY;
+	for (size_t i = 0; i < segments.size(); i++) {
+		const Segment &s = segments[i];
+		float t = std::min(std::max(alongSegment(s, x, y), 0.0f), s.length);
+		float dx = s.from.x + s.dir_x * t - x, dy = s.from.y + s.dir_y * t - y;
+		float d = dx * dx + dy * dy;
+		if (d < best) {
+			best = d;
+			nearest = (int)i;
+		}
+	}
+	return nearest;
+}
+
+point Centreline::pointAt(float distance, float &dir_x, float &dir_y) const {
+	dir_x = 0.0f;
+	dir_y = 1.0f;
+	if (segments.empty())
+		return { 0.0f, 0.0f };
+
+	// the segments are in order round the loop, so the one holding a distance is a binary search away
+	float along = fmodf(distance + startAlong, lapLength);
+	if (along < 0)
+		along += lapLength;
+	size_t low = 0, high = segments.size();
+	while (high - low > 1) {
+		size_t middle = (low + high) / 2;
+		if (segments[middle].along <= along)
+			low = middle;
+		else
+			high = middle;
+	}
+
+	const Segment &s = segments[low];
+	float t = std::min(along - s.along, s.length);
+	dir_x = s.dir_x;
+	dir_y = s.dir_y;
+	return { s.from.x + s.dir_x * t, s.from.y + s.dir_y * t };
+}
+
+point Centreline::segmentEnd(int segment) const {
+	if (segments.empty())
+		return { 0.0f, 0.0f };
+	int n = (int)segments.size();
+	return segments[((segment + 1) % n + n) % n].from;
+}
+
+float Centreline::project(float x, float y, int &segment) const {
+	if (segments.empty())
+		return 0.0f;
+
+	// off the end of a segment moves on to the next, off the start back to the one before.
+	// round the outside of a corner a point is off the end of one and the start of the
+	// next, so it settles on the corner itself - and no car moves a whole segment a tick,
+	// so a couple of steps either way is as far as it ever needs to look
+	int n = (int)segments.size();
+	int s = segment % n;
+	float t = alongSegment(segments[s], x, y);
+	for (int steps = 0; steps < 4 && t > segments[s].length; steps++) {
+		int next = (s + 1) % n;
+		float nextT = alongSegment(segments[next], x, y);
+		if (nextT < 0)
+			break;
+		s = next;
+		t = nextT;
+	}
+	for (int steps = 0; steps < 4 && t < 0; steps++) {
+		int previous = (s + n - 1) % n;
+		float previousT = alongSegment(segments[previous], x, y);
+		if (previousT > segments[previous].length)
+			break;
+		s = previous;
+		t = previousT;
+	}
+
+	segment = s;
+	t = std::min(std::max(t, 0.0f), segments[s].length);
+	return fromStart(segments[s].along + t);
+}
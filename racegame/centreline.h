@@ -0,0 +1,64 @@
+#pragma once
+
+// the middle of the road, as a closed run of segments through the waypoints, measured
+// round from the start line. how far round the lap a car is comes from projecting it
+// onto the segment it was on last tick, or the next one along - the same few sums
+// whatever the size of the circuit, so every car's place and splits can be kept up to
+// date each tick without testing it against any timing line
+
+#include <vector>
+#include "geometry.h"
+#include "collision.h"
+
+class Centreline {
+public:
+	// joins the waypoints into a loop, finding where the start line and each sector line
+	// cross it - needs at least three different waypoints, and skips any repeats
+	void build(ArrayView<point> waypoints, const edge &startLine, EdgeSpan sectorLines);
+
+	bool empty() const { return segments.empty(); }
+
+	// once round, start line to start line
+	float length() const { return lapLength; }
+
+	// how far round from the start line the point on the centreline nearest (x, y) is, from
+	// 0 up to length(). segment is where to start looking, and is moved along to wherever
+	// the point is found - cars move a fraction of a segment a tick, so it rarely moves
+	float project(float x, float y, int &segment) const;
+
+	// the point a distance round from the start line, and the way the road runs there
+	point pointAt(float distance, float &dir_x, float &dir_y) const;
+
+	// the segment nearest a point, looking at them all - the first hint for project()
+	int nearestSegment(float x, float y) const;
+
+	// the waypoint a segment runs to - the start of the next one, as repeated waypoints
+	// are skipped and segment numbers don't follow the waypoints' own
+	point segmentEnd(int segment) const;
+
+	// where each sector line crosses, in the order cars reach them from the start line
+	const std::vector<float> &sectorDistances() const { return sectors; }
+
+private:
+	struct Segment {
+		point from;
+		float dir_x, dir_y;		// unit direction to the next waypoint
+		float length;
+		float along;			// distance of from round the loop from the first waypoint
+	};
+
+	std::vector<Segment> segments;
+	std::vector<float> sectors;
+	float lapLength = 0.0f;
+	float startAlong = 0.0f;	// the start line's distance round from the first waypoint
+
+	// distance along a segment of the point nearest (x, y), which may be off either end
+	float alongSegment(const Segment &s, float x, float y) const;
+
+	// distance round from the first waypoint to where a line crosses the loop, or to the
+	// point nearest its middle if it doesn't
+	float crossing(const edge &line) const;
+
+	// wraps a distance round from the first waypoint into one from the start line
+	float fromStart(float along) const;
+};
@@ -0,0 +1,54 @@
+#include "chunkindex.h"
+#include <algorithm>
+#include <cmath>
+
+void ChunkIndex::clear(float size) {
+	chunkSize = size;
+	spill = 0.0f;
+	entries.clear();
+}
+
+int ChunkIndex::column(float x) const {
+	return (int)floor(x / chunkSize);
+}
+
+int ChunkIndex::row(float y) const {
+	return (int)floor(y / chunkSize);
+}
+
+void ChunkIndex::add(int column, int row, const Bounds &bounds, GLint first, GLsizei count) {
+	float left = column * chunkSize, bottom = row * chunkSize;
+	spill = std::max(spill, std::max(left - bounds.minX, bounds.maxX - (left + chunkSize)));
+	spill = std::max(spill, std::max(bottom - bounds.minY, bounds.maxY - (bottom + chunkSize)));
+	entries.push_back({ column, row, bounds, first, count });
+}
+
+void ChunkIndex::visible(const Bounds &view, std::vector<GLint> &firsts, std::vector<GLsizei> &counts) const {
+	firsts.clear();
+	counts.clear();
+
+	// a chunk whose contents spill over can be in view from a square or two off it
+	int firstColumn = column(view.minX - spill), lastColumn = column(view.maxX + spill);
+	int firstRow = row(view.minY - spill), lastRow = row(view.maxY + spill);
+	for (int r = firstRow; r <= lastRow; r++) {
+		Chunk key = {};
+		key.column = firstColumn;
+		key.row = r;
+		auto chunk = std::lower_bound(entries.begin(), entries.end(), key, [](const Chunk &a, const Chunk &b) {
+			return a.row != b.row ? a.row < b.row : a.column < b.column;
+		});
+
+		for (; chunk != entries.end() && chunk->row == r && chunk->column <= lastColumn; ++chunk) {
+			if (!chunk->bounds.overlaps(view))
+				continue;
+
+			// chunks next to each other in a row follow on in the batch, so they join into one run
+			if (!counts.empty() && firsts.back() + counts.back() == chunk->first)
+				counts.back() += chunk->count;
+			else {
+				firsts.push_back(chunk->first);
+				counts.push_back(chunk->count);
+			}
+		}
+	}
+}
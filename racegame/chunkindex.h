@@ -0,0 +1,52 @@
+#pragma once
+
+// the world cut into square chunks for drawing - a layer keeps everything in one batch,
+// grouped so each chunk is a run of vertices, and a frame only draws the runs of the
+// chunks the camera can see. finding them is a binary search per row of chunks in view,
+// so the cost of a frame follows what is on screen rather than the size of the track
+
+#include <vector>
+#include "graphics.h"
+
+// an axis aligned rectangle in world units
+struct Bounds {
+	float minX, minY, maxX, maxY;
+
+	bool overlaps(const Bounds &other) const {
+		return maxX >= other.minX && minX <= other.maxX && maxY >= other.minY && minY <= other.maxY;
+	}
+};
+
+class ChunkIndex {
+public:
+	// forgets every chunk, and sets the size of the next ones
+	void clear(float chunkSize);
+
+	float size() const { return chunkSize; }
+
+	// the chunk a coordinate falls in
+	int column(float x) const;
+	int row(float y) const;
+
+	// adds a chunk's run of vertices - chunks go in a row at a time from the bottom up,
+	// left to right along each, which is the order their runs should sit in the batch.
+	// bounds cover everything drawn in the chunk, which may spill past its square
+	void add(int column, int row, const Bounds &bounds, GLint first, GLsizei count);
+
+	// the runs of every chunk overlapping view, with neighbours along a row joined into one
+	void visible(const Bounds &view, std::vector<GLint> &firsts, std::vector<GLsizei> &counts) const;
+
+	size_t chunks() const { return entries.size(); }
+
+private:
+	struct Chunk {
+		int column, row;
+		Bounds bounds;
+		GLint first;
+		GLsizei count;
+	};
+
+	float chunkSize = 32.0f;
+	float spill = 0.0f;		// the furthest any chunk's bounds reach past its square
+	std::vector<Chunk> entries;
+};
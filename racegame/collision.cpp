@@ -0,0 +1,179 @@
+#include "collision.h"
+#include <cmath>
+#include <algorithm>
+
+// segments that lie along the same line - all four points have to be on it, and the
+// two segments have to overlap along it
+static bool collinearOverlap(const edge &a, const edge &b) {
+	// measure along whichever segment is longer, in case the other is just a point
+	edge line = a;
+	float ax = a.p2.x - a.p1.x, ay = a.p2.y - a.p1.y;
+	float bx = b.p2.x - b.p1.x, by = b.p2.y - b.p1.y;
+	if (bx * bx + by * by > ax * ax + ay * ay)
+		line = b;
+
+	float dx = line.p2.x - line.p1.x, dy = line.p2.y - line.p1.y;
+
+	// both are points
+	if (dx == 0 && dy == 0)
+		return a.p1.x == b.p1.x && a.p1.y == b.p1.y;
+
+	const point *points[4] = { &a.p1, &a.p2, &b.p1, &b.p2 };
+	float along[4];
+	for (int i = 0; i < 4; i++) {
+		float px = points[i]->x - line.p1.x, py = points[i]->y - line.p1.y;
+		if (px * dy - py * dx != 0)
+			return false;
+		along[i] = px * dx + py * dy;
+	}
+
+	return std::max(std::min(along[0], along[1]), std::min(along[2], along[3])) <=
+		std::min(std::max(along[0], along[1]), std::max(along[2], along[3]));
+}
+
+// checks whether two line segments cross
+// the distances to the point of intersection along each segment are num1 / den and
+// num2 / den - rather than dividing, both numerators are compared against den, which
+// also means parallel segments (den of 0) never produce inf or NaN
+bool segmentsIntersect(const edge &a, const edge &b) {
+	float rx = a.p2.x - a.p1.x, ry = a.p2.y - a.p1.y;
+	float sx = b.p2.x - b.p1.x, sy = b.p2.y - b.p1.y;
+	float wx = a.p1.x - b.p1.x, wy = a.p1.y - b.p1.y;
+
+	float den = sy * rx - sx * ry;
+	float num1 = sx * wy - sy * wx;
+	float num2 = rx * wy - ry * wx;
+
+	// parallel, or one of them has no length
+	if (den == 0)
+		return num1 == 0 && num2 == 0 && collinearOverlap(a, b);
+
+	if (den < 0) {
+		den = -den;
+		num1 = -num1;
+		num2 = -num2;
+	}
+
+	// if both distances are between 0 and 1, there is a collision
+	return num1 >= 0 && num1 <= den && num2 >= 0 && num2 <= den;
+}
+
+// checks to see if any edge in a intersects any edge in b
+bool isColliding(EdgeSpan a, EdgeSpan b) {
+	return edgesHitSegments(a, b.data, b.count);
+}
+
+// walks the segment one row of cells at a time, clipping it to the row to find which columns it covers
+template <typename Visit> void TrackGrid::forEachCell(const edge &e, Visit visit) const {
+	float x1 = e.p1.x * invCellSize, y1 = e.p1.y * invCellSize;
+	float x2 = e.p2.x * invCellSize, y2 = e.p2.y * invCellSize;
+
+	// always walk upwards
+	if (y2 < y1) {
+		std::swap(x1, x2);
+		std::swap(y1, y2);
+	}
+
+	int firstRow = (int)floor(y1);
+	int lastRow = (int)floor(y2);
+	float dxdy = y2 != y1 ? (x2 - x1) / (y2 - y1) : 0.0f;
+
+	for (int cy = firstRow; cy <= lastRow; cy++) {
+		// x where the segment enters and leaves this row
+		float enter = cy == firstRow ? x1 : x1 + (cy - y1) * dxdy;
+		float leave = cy == lastRow ? x2 : x1 + (cy + 1 - y1) * dxdy;
+		if (leave < enter)
+			std::swap(enter, leave);
+
+		// widen slightly so rounding never drops a cell the segment only just reaches
+		enter -= 0.001f;
+		leave += 0.001f;
+
+		for (int cx = (int)floor(enter); cx <= (int)floor(leave); cx++)
+			visit(cx, cy);
+	}
+}
+
+void TrackGrid::build(EdgeSpan edges, float size) {
+	cellSize = size;
+	invCellSize = 1.0f / size;
+
+	// aim for around two buckets per edge, as a power of two so a mask picks the bucket
+	uint32_t buckets = 64;
+	while (buckets < edges.size() * 2)
+		buckets *= 2;
+	bucketMask = buckets - 1;
+
+	// first pass counts how many edges land in each bucket...
+	ownedStarts.assign(buckets + 1, 0);
+	for (size_t i = 0; i < edges.size(); i++)
+		forEachCell(edges[i], [&](int cx, int cy) { ownedStarts[bucket(cx, cy) + 1]++; });
+
+	for (uint32_t b = 0; b < buckets; b++)
+		ownedStarts[b + 1] += ownedStarts[b];
+
+	// ...second pass copies them into place
+	std::vector<uint32_t> fill(ownedStarts.begin(), ownedStarts.end() - 1);
+	ownedItems.resize(ownedStarts[buckets]);
+	for (size_t i = 0; i < edges.size(); i++)
+		forEachCell(edges[i], [&](int cx, int cy) { ownedItems[fill[bucket(cx, cy)]++] = edges[i]; });
+
+	bucketStart = ownedStarts;
+	items = ownedItems;
+}
+
+bool TrackGrid::attach(float size, uint32_t bucketCount, const uint32_t *bucketStarts, const edge *stored, size_t storedCount) {
+	// only what can be checked without reading through the arrays
+	if (size <= 0 || bucketCount == 0 || (bucketCount & (bucketCount - 1)) != 0 || bucketStarts[bucketCount] != storedCount)
+		return false;
+
+	cellSize = size;
+	invCellSize = 1.0f / size;
+	bucketMask = bucketCount - 1;
+	bucketStart = ArrayView<uint32_t>(bucketStarts, bucketCount + 1);
+	items = EdgeSpan(stored, storedCount);
+
+	ownedStarts.clear();
+	ownedItems.clear();
+	return true;
+}
+
+bool TrackGrid::isColliding(EdgeSpan a) const {
+	if (a.empty() || items.empty())
+		return false;
+
+	// bounding box of everything being tested, in cells
+	float min_x = a[0].p1.x, max_x = a[0].p1.x, min_y = a[0].p1.y, max_y = a[0].p1.y;
+	for (size_t i = 0; i < a.size(); i++) {
+		min_x = std::min(min_x, std::min(a[i].p1.x, a[i].p2.x));
+		max_x = std::max(max_x, std::max(a[i].p1.x, a[i].p2.x));
+		min_y = std::min(min_y, std::min(a[i].p1.y, a[i].p2.y));
+		max_y = std::max(max_y, std::max(a[i].p1.y, a[i].p2.y));
+	}
+
+	int firstColumn = (int)floor(min_x * invCellSize), lastColumn = (int)floor(max_x * invCellSize);
+	int firstRow = (int)floor(min_y * invCellSize), lastRow = (int)floor(max_y * invCellSize);
+
+	// a car's box usually covers no more than four cells - remember which buckets have
+	// been tested so two cells hashing to the same bucket aren't tested twice
+	const int maxSeen = 16;
+	unsigned seen[maxSeen];
+	int seenCount = 0;
+
+	for (int cy = firstRow; cy <= lastRow; cy++) {
+		for (int cx = firstColumn; cx <= lastColumn; cx++) {
+			unsigned b = bucket(cx, cy);
+
+			if (std::find(seen, seen + seenCount, b) != seen + seenCount)
+				continue;
+			if (seenCount < maxSeen)
+				seen[seenCount++] = b;
+
+			if (edgesHitSegments(a, items.data + bucketStart[b], bucketStart[b + 1] - bucketStart[b]))
+				return true;
+		}
+	}
+
+	// no collisions detected
+	return false;
+}
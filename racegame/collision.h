@@ -0,0 +1,106 @@
+#pragma once
+
+// line intersection tests, plus a spatial index so cars only test nearby track edges
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include "geometry.h"
+
+// a run of edges somebody else owns - lets the same tests take a vector, a car's
+// fixed-size box or a single edge without copying any of them
+struct EdgeSpan {
+	const edge *data;
+	size_t count;
+
+	EdgeSpan() : data(nullptr), count(0) {}
+	EdgeSpan(const std::vector<edge> &edges) : data(edges.data()), count(edges.size()) {}
+	EdgeSpan(const CarEdges &edges) : data(edges.data()), count(edges.size()) {}
+	EdgeSpan(const edge &single) : data(&single), count(1) {}
+	EdgeSpan(const edge *edges, size_t n) : data(edges), count(n) {}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	const edge &operator[](size_t i) const { return data[i]; }
+};
+
+// checks whether two line segments cross or touch - parallel segments only count
+// if they lie on the same line and overlap, and a zero length segment acts as a point
+bool segmentsIntersect(const edge &a, const edge &b);
+
+// checks to see if any edge in a intersects any edge in b
+bool isColliding(EdgeSpan a, EdgeSpan b);
+
+// the batched test behind isColliding - probe edges sit in the lanes of a SIMD
+// register (a car's four sides fill one exactly) and each segment is broadcast across
+// them, so any number of segments can be streamed through without padding
+bool edgesHitSegments(EdgeSpan probe, const edge *segments, size_t count);
+
+// the implementations edgesHitSegments can use - the best one this cpu supports is
+// picked the first time it is called
+enum CollisionKernel {
+	KERNEL_SCALAR,
+	KERNEL_SSE2,
+	KERNEL_AVX
+};
+
+CollisionKernel collisionKernel();
+
+// switches implementation, returns false (leaving it alone) if this cpu can't run it
+bool setCollisionKernel(CollisionKernel kernel);
+
+const char *collisionKernelName(CollisionKernel kernel);
+
+// uniform grid over the track - each edge is stored in every cell it passes through,
+// so a car only needs testing against the edges in the few cells its box overlaps.
+// cells are hashed into a fixed number of buckets, so memory follows the number of
+// edges rather than the area the track covers
+class TrackGrid {
+public:
+	// buckets the given edges into square cells of cellSize units
+	void build(EdgeSpan edges, float cellSize = 4.0f);
+
+	// uses buckets that build() made earlier and were stored elsewhere, such as in a
+	// compiled track file - nothing is copied, so the arrays have to outlive the grid.
+	// bucketCount has to be a power of two, with bucketCount + 1 starts
+	bool attach(float cellSize, uint32_t bucketCount, const uint32_t *bucketStarts, const edge *items, size_t itemCount);
+
+	// checks whether any of the given edges cross an edge in the grid
+	bool isColliding(EdgeSpan a) const;
+
+	// the cell a point is in, and the edges stored with that cell - cells share buckets, so
+	// this can include edges from other cells too
+	int cellOf(float v) const { return (int)floor(v * invCellSize); }
+	EdgeSpan cellEdges(int cx, int cy) const {
+		unsigned b = bucket(cx, cy);
+		return EdgeSpan(items.data + bucketStart[b], bucketStart[b + 1] - bucketStart[b]);
+	}
+
+	// number of edges stored, counting edges once per cell they touch
+	size_t storedEdges() const { return items.size(); }
+
+	// what attach() needs to rebuild this grid
+	float cell() const { return cellSize; }
+	uint32_t bucketCount() const { return bucketMask + 1; }
+	ArrayView<uint32_t> bucketStarts() const { return bucketStart; }
+	EdgeSpan storedItems() const { return items; }
+
+private:
+	float cellSize = 1.0f;
+	float invCellSize = 1.0f;
+	uint32_t bucketMask = 0;
+
+	// bucket b holds items[bucketStart[b]] up to items[bucketStart[b + 1]] - both point
+	// either into the vectors below, after build(), or at whatever attach() was given
+	ArrayView<uint32_t> bucketStart;
+	EdgeSpan items;
+
+	std::vector<uint32_t> ownedStarts;
+	std::vector<edge> ownedItems;
+
+	unsigned bucket(int cx, int cy) const { return ((unsigned)cx * 73856093u ^ (unsigned)cy * 19349663u) & bucketMask; }
+
+	// calls visit(cx, cy) for every cell the edge passes through
+	template <typename Visit> void forEachCell(const edge &e, Visit visit) const;
+};
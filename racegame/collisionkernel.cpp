@@ -0,0 +1,240 @@
+#include "collision.h"
+#include "simd.h"
+#include <algorithm>
+
+// the simd paths load an edge as four floats: p1.x, p1.y, p2.x, p2.y
+static_assert(sizeof(edge) == 4 * sizeof(float), "edge must be four packed floats");
+
+static bool hitScalar(EdgeSpan probe, const edge *segments, size_t count) {
+	for (size_t j = 0; j < count; j++) {
+		for (size_t i = 0; i < probe.size(); i++) {
+			if (segmentsIntersect(probe[i], segments[j]))
+				return true;
+		}
+	}
+	return false;
+}
+
+// lanes where den came out as 0 are parallel or zero length, and need the exact
+// treatment segmentsIntersect gives them - these are rare so they go one at a time
+static bool hitParallelLanes(EdgeSpan probe, size_t first, int laneMask, const edge &segment) {
+	for (int lane = 0; lane < 4; lane++) {
+		if ((laneMask & (1 << lane)) && segmentsIntersect(probe[first + lane], segment))
+			return true;
+	}
+	return false;
+}
+
+#ifdef RACEGAME_SSE2
+
+// up to four probe edges, one per lane - the same values segmentsIntersect works out for a
+// pair: each edge's start and the vector along it
+struct ProbeLanes {
+	alignas(16) float p1x[4];	// aligned, so the avx path can broadcast each array as an __m128
+	alignas(16) float p1y[4];
+	alignas(16) float rx[4];
+	alignas(16) float ry[4];
+	int valid;	// bit per lane that holds a real edge
+};
+
+static void fillLanes(EdgeSpan probe, size_t first, ProbeLanes &lanes) {
+	lanes.valid = 0;
+	for (size_t lane = 0; lane < 4; lane++) {
+		if (first + lane < probe.size()) {
+			const edge &e = probe[first + lane];
+			lanes.p1x[lane] = e.p1.x;
+			lanes.p1y[lane] = e.p1.y;
+			lanes.rx[lane] = e.p2.x - e.p1.x;
+			lanes.ry[lane] = e.p2.y - e.p1.y;
+			lanes.valid |= 1 << lane;
+		}
+		else {
+			lanes.p1x[lane] = lanes.p1y[lane] = lanes.rx[lane] = lanes.ry[lane] = 0;
+		}
+	}
+}
+
+static bool hitSse2(EdgeSpan probe, const edge *segments, size_t count) {
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+
+	for (size_t first = 0; first < probe.size(); first += 4) {
+		ProbeLanes lanes;
+		fillLanes(probe, first, lanes);
+		__m128 p1x = _mm_loadu_ps(lanes.p1x), p1y = _mm_loadu_ps(lanes.p1y);
+		__m128 rx = _mm_loadu_ps(lanes.rx), ry = _mm_loadu_ps(lanes.ry);
+
+		for (size_t j = 0; j < count; j++) {
+			// broadcast the segment to every lane
+			__m128 seg = _mm_loadu_ps(&segments[j].p1.x);
+			__m128 qx = _mm_shuffle_ps(seg, seg, _MM_SHUFFLE(0, 0, 0, 0));
+			__m128 qy = _mm_shuffle_ps(seg, seg, _MM_SHUFFLE(1, 1, 1, 1));
+			__m128 sx = _mm_sub_ps(_mm_shuffle_ps(seg, seg, _MM_SHUFFLE(2, 2, 2, 2)), qx);
+			__m128 sy = _mm_sub_ps(_mm_shuffle_ps(seg, seg, _MM_SHUFFLE(3, 3, 3, 3)), qy);
+
+			__m128 wx = _mm_sub_ps(p1x, qx), wy = _mm_sub_ps(p1y, qy);
+			__m128 den = _mm_sub_ps(_mm_mul_ps(sy, rx), _mm_mul_ps(sx, ry));
+			__m128 num1 = _mm_sub_ps(_mm_mul_ps(sx, wy), _mm_mul_ps(sy, wx));
+			__m128 num2 = _mm_sub_ps(_mm_mul_ps(rx, wy), _mm_mul_ps(ry, wx));
+
+			// flip signs so den is positive, then 0 <= num <= den stands in for 0 <= num / den <= 1
+			__m128 sign = _mm_and_ps(den, signBit);
+			den = _mm_xor_ps(den, sign);
+			num1 = _mm_xor_ps(num1, sign);
+			num2 = _mm_xor_ps(num2, sign);
+
+			__m128 hit = _mm_and_ps(_mm_cmpge_ps(num1, zero), _mm_cmple_ps(num1, den));
+			hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(num2, zero), _mm_cmple_ps(num2, den)));
+			hit = _mm_and_ps(hit, _mm_cmpgt_ps(den, zero));
+
+			if (_mm_movemask_ps(hit) & lanes.valid)
+				return true;
+
+			int parallel = _mm_movemask_ps(_mm_cmpeq_ps(den, zero)) & lanes.valid;
+			if (parallel && hitParallelLanes(probe, first, parallel, segments[j]))
+				return true;
+		}
+	}
+	return false;
+}
+
+#endif
+
+#ifdef RACEGAME_AVX
+
+// same as hitSse2, but two segments at a time - the low four lanes take one segment and
+// the high four the next, with the probe edges repeated in both halves
+RACEGAME_TARGET_AVX static bool hitAvx(EdgeSpan probe, const edge *segments, size_t count) {
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+	for (size_t first = 0; first < probe.size(); first += 4) {
+		ProbeLanes lanes;
+		fillLanes(probe, first, lanes);
+		__m256 p1x = _mm256_broadcast_ps((const __m128 *)lanes.p1x);
+		__m256 p1y = _mm256_broadcast_ps((const __m128 *)lanes.p1y);
+		__m256 rx = _mm256_broadcast_ps((const __m128 *)lanes.rx);
+		__m256 ry = _mm256_broadcast_ps((const __m128 *)lanes.ry);
+		int valid = lanes.valid | (lanes.valid << 4);
+
+		size_t j = 0;
+		for (; j + 2 <= count; j += 2) {
+			// segments j and j + 1 are eight floats in a row - permutes stay within each half
+			__m256 seg = _mm256_loadu_ps(&segments[j].p1.x);
+			__m256 qx = _mm256_permute_ps(seg, _MM_SHUFFLE(0, 0, 0, 0));
+			__m256 qy = _mm256_permute_ps(seg, _MM_SHUFFLE(1, 1, 1, 1));
+			__m256 sx = _mm256_sub_ps(_mm256_permute_ps(seg, _MM_SHUFFLE(2, 2, 2, 2)), qx);
+			__m256 sy = _mm256_sub_ps(_mm256_permute_ps(seg, _MM_SHUFFLE(3, 3, 3, 3)), qy);
+
+			__m256 wx = _mm256_sub_ps(p1x, qx), wy = _mm256_sub_ps(p1y, qy);
+			__m256 den = _mm256_sub_ps(_mm256_mul_ps(sy, rx), _mm256_mul_ps(sx, ry));
+			__m256 num1 = _mm256_sub_ps(_mm256_mul_ps(sx, wy), _mm256_mul_ps(sy, wx));
+			__m256 num2 = _mm256_sub_ps(_mm256_mul_ps(rx, wy), _mm256_mul_ps(ry, wx));
+
+			__m256 sign = _mm256_and_ps(den, signBit);
+			den = _mm256_xor_ps(den, sign);
+			num1 = _mm256_xor_ps(num1, sign);
+			num2 = _mm256_xor_ps(num2, sign);
+
+			__m256 hit = _mm256_and_ps(_mm256_cmp_ps(num1, zero, _CMP_GE_OQ), _mm256_cmp_ps(num1, den, _CMP_LE_OQ));
+			hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(num2, zero, _CMP_GE_OQ), _mm256_cmp_ps(num2, den, _CMP_LE_OQ)));
+			hit = _mm256_and_ps(hit, _mm256_cmp_ps(den, zero, _CMP_GT_OQ));
+
+			if (_mm256_movemask_ps(hit) & valid)
+				return true;
+
+			int parallel = _mm256_movemask_ps(_mm256_cmp_ps(den, zero, _CMP_EQ_OQ)) & valid;
+			if (parallel) {
+				if (hitParallelLanes(probe, first, parallel & 15, segments[j]) ||
+					hitParallelLanes(probe, first, parallel >> 4, segments[j + 1]))
+					return true;
+			}
+		}
+
+		// an odd segment left over
+		if (j < count && hitSse2(EdgeSpan(probe.data + first, std::min<size_t>(4, probe.size() - first)), segments + j, 1))
+			return true;
+	}
+	return false;
+}
+
+#endif
+
+static bool cpuHasAvx() {
+#if defined(RACEGAME_AVX) && defined(_MSC_VER)
+	// the cpu has to support it, and the os has to save the wider registers
+	int info[4];
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	return osxsave && avx && (_xgetbv(0) & 6) == 6;
+#elif defined(RACEGAME_AVX)
+	return __builtin_cpu_supports("avx");
+#else
+	return false;
+#endif
+}
+
+static bool kernelSupported(CollisionKernel kernel) {
+	switch (kernel) {
+	case KERNEL_SCALAR:
+		return true;
+	case KERNEL_SSE2:
+#ifdef RACEGAME_SSE2
+		return true;
+#else
+		return false;
+#endif
+	case KERNEL_AVX:
+		return cpuHasAvx();
+	}
+	return false;
+}
+
+// avx by default where it runs - box pairs only come out a few percent ahead of sse2, as a
+// box is just four edges, but the ray walk's eight lanes take a third off its time.
+// racebench times both with every kernel, to keep that checked
+static CollisionKernel &activeKernel() {
+	static CollisionKernel kernel = kernelSupported(KERNEL_AVX) ? KERNEL_AVX :
+		kernelSupported(KERNEL_SSE2) ? KERNEL_SSE2 : KERNEL_SCALAR;
+	return kernel;
+}
+
+CollisionKernel collisionKernel() {
+	return activeKernel();
+}
+
+bool setCollisionKernel(CollisionKernel kernel) {
+	if (!kernelSupported(kernel))
+		return false;
+
+	activeKernel() = kernel;
+	return true;
+}
+
+const char *collisionKernelName(CollisionKernel kernel) {
+	switch (kernel) {
+	case KERNEL_SCALAR:
+		return "scalar";
+	case KERNEL_SSE2:
+		return "sse2";
+	case KERNEL_AVX:
+		return "avx";
+	}
+	return "unknown";
+}
+
+bool edgesHitSegments(EdgeSpan probe, const edge *segments, size_t count) {
+	switch (activeKernel()) {
+#ifdef RACEGAME_AVX
+	case KERNEL_AVX:
+		return hitAvx(probe, segments, count);
+#endif
+#ifdef RACEGAME_SSE2
+	case KERNEL_SSE2:
+		return hitSse2(probe, segments, count);
+#endif
+	default:
+		return hitScalar(probe, segments, count);
+	}
+}
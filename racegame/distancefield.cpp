@@ -0,0 +1,258 @@
+#include "distancefield.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+static float distanceToSegment(const edge &e, float x, float y) {
+	float dx = e.p2.x - e.p1.x, dy = e.p2.y - e.p1.y, length2 = dx * dx + dy * dy;
+	float t = length2 > 0 ? ((x - e.p1.x) * dx + (y - e.p1.y) * dy) / length2 : 0.0f;
+	t = std::max(0.0f, std::min(1.0f, t));
+
+	float ox = e.p1.x + dx * t - x, oy = e.p1.y + dy * t - y;
+	return sqrt(ox * ox + oy * oy);
+}
+
+void DistanceField::build(EdgeSpan walls, float size, float band) {
+	// samples start out at the band and read as road - nothing is stored far from a wall
+	samples.reset(size, band);
+	const int mask = Samples::tileSize - 1;
+
+	// unsigned distance first - each wall stamps the samples within band of it, a row at
+	// a time over just the stretch of the row the band covers
+	for (size_t i = 0; i < walls.size(); i++) {
+		const edge &e = walls[i];
+		float dx = e.p2.x - e.p1.x, dy = e.p2.y - e.p1.y;
+		int firstRow = (int)ceil((std::min(e.p1.y, e.p2.y) - band) / size);
+		int lastRow = (int)floor((std::max(e.p1.y, e.p2.y) + band) / size);
+
+		for (int cy = firstRow; cy <= lastRow; cy++) {
+			float y = cy * size;
+
+			// the part of the wall within band of this row, widened by the band
+			float t0 = 0.0f, t1 = 1.0f;
+			if (fabs(dy) > 1e-6f) {
+				t0 = (y - band - e.p1.y) / dy;
+				t1 = (y + band - e.p1.y) / dy;
+				if (t1 < t0)
+					std::swap(t0, t1);
+				t0 = std::max(t0, 0.0f);
+				t1 = std::min(t1, 1.0f);
+				if (t0 > t1)
+					continue;
+			}
+			float x0 = e.p1.x + dx * t0, x1 = e.p1.x + dx * t1;
+			int firstColumn = (int)ceil((std::min(x0, x1) - band) / size);
+			int lastColumn = (int)floor((std::max(x0, x1) + band) / size);
+
+			for (int cx = firstColumn; cx <= lastColumn; cx++) {
+				float d = distanceToSegment(e, cx * size, y);
+				if (d >= band)
+					continue;
+
+				uint32_t tile = samples.addTile(cx >> Samples::tileShift, cy >> Samples::tileShift);
+				float &sample = samples.tileCellsFor(tile)[(cy & mask) * Samples::tileSize + (cx & mask)];
+				sample = std::min(sample, d);
+			}
+		}
+	}
+
+	// then the sign - a sample is on the road if a line from it out to the left crosses
+	// the walls an odd number of times. the tiles are taken a row of tiles at a time, with
+	// the walls spanning that row gathered up first
+	std::unordered_map<int, std::vector<uint32_t>> tileRows;
+	for (uint32_t tile = 0; tile < samples.tileCount(); tile++) {
+		int tx, ty;
+		samples.tileCoords(tile, tx, ty);
+		tileRows[ty].push_back(tile);
+	}
+
+	const float rowHeight = Samples::tileSize * size;
+	std::unordered_map<int, std::vector<uint32_t>> rowWalls;
+	for (size_t i = 0; i < walls.size(); i++) {
+		int first = (int)floor(std::min(walls[i].p1.y, walls[i].p2.y) / rowHeight);
+		int last = (int)floor(std::max(walls[i].p1.y, walls[i].p2.y) / rowHeight);
+		for (int ty = first; ty <= last; ty++) {
+			if (tileRows.count(ty))
+				rowWalls[ty].push_back((uint32_t)i);
+		}
+	}
+
+	std::vector<float> crossings;
+	for (std::unordered_map<int, std::vector<uint32_t>>::const_iterator row = tileRows.begin(); row != tileRows.end(); ++row) {
+		int ty = row->first;
+		const std::vector<uint32_t> &spanning = rowWalls[ty];
+
+		for (int r = 0; r < Samples::tileSize; r++) {
+			int cy = ty * Samples::tileSize + r;
+			float y = cy * size;
+
+			// where the walls cross this line - each wall counts from its lower end up to
+			// but not including its upper one, so a shared corner is only counted once
+			crossings.clear();
+			for (size_t i = 0; i < spanning.size(); i++) {
+				const edge &e = walls[spanning[i]];
+				float lowY = std::min(e.p1.y, e.p2.y), highY = std::max(e.p1.y, e.p2.y);
+				if (y < lowY || y >= highY)
+					continue;
+				crossings.push_back(e.p1.x + (y - e.p1.y) * (e.p2.x - e.p1.x) / (e.p2.y - e.p1.y));
+			}
+			std::sort(crossings.begin(), crossings.end());
+
+			for (size_t t = 0; t < row->second.size(); t++) {
+				uint32_t tile = row->second[t];
+				int tx, unused;
+				samples.tileCoords(tile, tx, unused);
+				float *values = samples.tileCellsFor(tile) + r * Samples::tileSize;
+
+				for (int c = 0; c < Samples::tileSize; c++) {
+					float x = (tx * Samples::tileSize + c) * size;
+					size_t left = std::upper_bound(crossings.begin(), crossings.end(), x) - crossings.begin();
+					if (left % 2 == 0)
+						values[c] = -values[c];
+				}
+			}
+		}
+	}
+
+	samples.finish();
+}
+
+bool DistanceField::attach(float size, float band, ArrayView<TileSlot> slots, ArrayView<float> stored) {
+	return samples.attach(size, band, slots, stored);
+}
+
+void DistanceField::corners(float x, float y, float value[4], float &tx, float &ty, TileCache &cache) const {
+	int cx = samples.cellIndex(x), cy = samples.cellIndex(y);
+	tx = x * samples.inverseCell() - cx;
+	ty = y * samples.inverseCell() - cy;
+
+	// all four samples are usually in the same tile, so it only has to be found once
+	const int mask = Samples::tileSize - 1;
+	if ((cx & mask) != mask && (cy & mask) != mask) {
+		int tileX = cx >> Samples::tileShift, tileY = cy >> Samples::tileShift;
+		if (!cache.valid || cache.tx != tileX || cache.ty != tileY) {
+			cache.tile = samples.findTile(tileX, tileY);
+			cache.tx = tileX;
+			cache.ty = tileY;
+			cache.valid = true;
+		}
+		if (!cache.tile) {
+			value[0] = value[1] = value[2] = value[3] = samples.fallback();
+			return;
+		}
+
+		const float *s = cache.tile + (cy & mask) * Samples::tileSize + (cx & mask);
+		value[0] = s[0];
+		value[1] = s[1];
+		value[2] = s[Samples::tileSize];
+		value[3] = s[Samples::tileSize + 1];
+		return;
+	}
+
+	value[0] = samples.cellAt(cx, cy);
+	value[1] = samples.cellAt(cx + 1, cy);
+	value[2] = samples.cellAt(cx, cy + 1);
+	value[3] = samples.cellAt(cx + 1, cy + 1);
+}
+
+float DistanceField::sample(float x, float y, TileCache &cache) const {
+	float v[4], tx, ty;
+	corners(x, y, v, tx, ty, cache);
+	float bottom = v[0] + (v[1] - v[0]) * tx;
+	float top = v[2] + (v[3] - v[2]) * tx;
+	return bottom + (top - bottom) * ty;
+}
+
+float DistanceField::distance(float x, float y) const {
+	TileCache cache;
+	return sample(x, y, cache);
+}
+
+float DistanceField::distance(float x, float y, point &normal) const {
+	TileCache cache;
+	float v[4], tx, ty;
+	corners(x, y, v, tx, ty, cache);
+	float bottom = v[0] + (v[1] - v[0]) * tx;
+	float top = v[2] + (v[3] - v[2]) * tx;
+
+	// slope of the interpolation - the cell size scales both parts alike, so it drops out
+	// when the direction is normalised
+	float gx = (v[1] - v[0]) * (1 - ty) + (v[3] - v[2]) * ty;
+	float gy = top - bottom;
+	float length = sqrt(gx * gx + gy * gy);
+	if (length > 0)
+		normal = { gx / length, gy / length };
+	else
+		normal = { 0.0f, 0.0f };
+
+	return bottom + (top - bottom) * ty;
+}
+
+// the corners of a box are the ends of its left and right sides - the middles of those
+// are tested too, as a box is twice as long as it's wide and a wall's corner can reach
+// into a long side between its ends
+static void boxPoints(const CarEdges &box, point points[6]) {
+	const edge &left = box[0], &right = box[2];
+	points[0] = left.p1;
+	points[1] = left.p2;
+	points[2] = right.p1;
+	points[3] = right.p2;
+	points[4] = { (left.p1.x + left.p2.x) * 0.5f, (left.p1.y + left.p2.y) * 0.5f };
+	points[5] = { (right.p1.x + right.p2.x) * 0.5f, (right.p1.y + right.p2.y) * 0.5f };
+}
+
+static float lengthSquared(const edge &e) {
+	float dx = e.p2.x - e.p1.x, dy = e.p2.y - e.p1.y;
+	return dx * dx + dy * dy;
+}
+
+bool DistanceField::isColliding(const CarEdges &box, const TrackGrid &edges) const {
+	point points[6];
+	boxPoints(box, points);
+	TileCache cache;
+	float nearest = INFINITY;
+	for (int i = 0; i < 4; i++) {
+		float d = sample(points[i].x, points[i].y, cache);
+		if (d <= 0)
+			return true;
+		nearest = std::min(nearest, d);
+	}
+
+	// between samples the field is a weighted sum of ones at most half a cell's diagonal
+	// away on average, so it reads high by less than 0.75 of a cell. no point on the
+	// outline is further than half a long side from a corner, so corners clear of the
+	// walls by more than that leave nothing touching - most boxes stop here. lengths
+	// are compared squared, to save the roots
+	float long2 = lengthSquared(box[0]), short2 = lengthSquared(box[1]);
+	float clear = nearest - cell() * 0.75f;
+	if (clear > 0 && clear * clear > long2 * 0.25f)
+		return false;
+
+	for (int i = 4; i < 6; i++) {
+		float d = sample(points[i].x, points[i].y, cache);
+		if (d <= 0)
+			return true;
+		nearest = std::min(nearest, d);
+	}
+
+	// with the middles as well, no point on the outline is further than a quarter of a
+	// long side or half a short one from one of the six
+	clear = nearest - cell() * 0.75f;
+	return !(clear > 0 && clear * clear > std::max(long2 * 0.0625f, short2 * 0.25f)) && edges.isColliding(box);
+}
+
+float DistanceField::nearestPoint(const CarEdges &box, point &normal) const {
+	point points[6];
+	boxPoints(box, points);
+	float nearest = INFINITY;
+	for (int i = 0; i < 6; i++) {
+		point n;
+		float d = distance(points[i].x, points[i].y, n);
+		if (d < nearest) {
+			nearest = d;
+			normal = n;
+		}
+	}
+	return nearest;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+// signed distance to the walls, sampled on a fine grid close to them - positive on the
+// road, negative inside or beyond a wall. a car's box is tested by looking up its corners
+// and the middles of its long sides, and the slope of the field gives the direction
+// straight out of the nearest wall, so a car that hits one can be slid along it rather
+// than stopped dead
+
+#include <cstdint>
+#include "geometry.h"
+#include "collision.h"
+#include "tilemap.h"
+
+class DistanceField {
+public:
+	// rasterises the walls - which side is road comes from counting wall crossings, so the
+	// walls should form closed loops (an outer edge, and the edge of any island in it).
+	// only samples within band units of a wall are stored, anything further reads as road
+	void build(EdgeSpan walls, float cellSize = 0.25f, float band = 1.5f);
+
+	// uses samples built earlier and stored elsewhere, such as in a compiled track file -
+	// nothing is copied, so the arrays have to outlive the field
+	bool attach(float cellSize, float band, ArrayView<TileSlot> slots, ArrayView<float> samples);
+
+	// signed distance to the nearest wall, interpolated between the four samples around
+	// the point
+	float distance(float x, float y) const;
+
+	// the same, along with the unit direction away from the nearest wall - zero where
+	// the field is flat, away from any wall
+	float distance(float x, float y, point &normal) const;
+
+	// whether a car's box is touching or inside a wall. its corners and the middles of its
+	// long sides are looked up - one inside a wall is a hit, and all of them clear by more
+	// than the gaps between them (and the field's error) is not. a box closer than that
+	// could have a wall's corner reaching into a side between them, so its sides are tested
+	// against the grid's edges, and it is never let off where the segment test would catch it
+	bool isColliding(const CarEdges &box, const TrackGrid &edges) const;
+
+	// the distance of whichever of those points is nearest a wall, and the direction out of
+	// the wall there
+	float nearestPoint(const CarEdges &box, point &normal) const;
+
+	bool empty() const { return samples.empty(); }
+
+	// what attach() needs to rebuild this field
+	float cell() const { return samples.cell(); }
+	float band() const { return samples.fallback(); }
+	ArrayView<TileSlot> slots() const { return samples.slots(); }
+	ArrayView<float> storedSamples() const { return samples.storedCells(); }
+
+private:
+	// 8x8 tiles - the band round a wall is thin, so smaller tiles waste less
+	typedef TileMap<float, 3> Samples;
+	Samples samples;
+
+	// the last tile looked up, so the points of one box don't each search the table for it
+	struct TileCache {
+		int tx = 0, ty = 0;
+		const float *tile = nullptr;
+		bool valid = false;
+	};
+
+	// the four samples round a point, and how far between them it lies
+	void corners(float x, float y, float value[4], float &tx, float &ty, TileCache &cache) const;
+	float sample(float x, float y, TileCache &cache) const;
+};
@@ -0,0 +1,21 @@
+#include "font.h"
+#include "graphics.h"
+
+void drawText(const BitmapFont &font, const std::string &text) {
+	// glyph rows are packed to the byte, not to the default 4
+	GLint alignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned char c = (unsigned char)text[i];
+		if (c < ' ' || c > '~')
+			continue;
+
+		// first byte is the advance, which is also the bitmap width
+		const unsigned char *glyph = font.glyphs[c - ' '];
+		glBitmap(glyph[0], font.height, 0, (GLfloat)font.descent, glyph[0], 0, glyph + 1);
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
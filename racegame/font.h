@@ -0,0 +1,20 @@
+#pragma once
+
+// bitmap text for the HUD - the glyphs are compiled in (see fontdata.cpp) and drawn with
+// glBitmap, so text needs a GL context but not GLUT, which the offscreen benchmark lacks
+
+#include <string>
+
+struct BitmapFont {
+	int height;		// rows in every glyph
+	int descent;	// rows below the baseline
+	const unsigned char *glyphs[95];	// printable ascii, ' ' to '~'
+};
+
+// the two sizes GLUT_BITMAP_HELVETICA_10/18 gave us
+extern const BitmapFont fontHelvetica10;
+extern const BitmapFont fontHelvetica18;
+
+// draws text from the current raster position, the same way glutBitmapString did -
+// characters outside printable ascii are skipped
+void drawText(const BitmapFont &font, const std::string &text);
@@ -0,0 +1,236 @@
+#include "font.h"
+
+// glyph bitmaps for printable ascii, taken from freeglut's fg_font_data.c (the X11
+// adobe helvetica fonts freeglut uses for GLUT_BITMAP_HELVETICA_10/18), so text looks
+// the same as it did through glutBitmapString - freeglut is MIT/X licensed
+//
+// each glyph is its advance width in pixels, then one row of bits per line from the
+// bottom up, (width + 7) / 8 bytes per row - the layout glBitmap takes
+
+static const unsigned char helvetica10_32[] = { 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; //  
+static const unsigned char helvetica10_33[] = { 3, 0, 0, 0, 64, 0, 64, 64, 64, 64, 64, 64, 0, 0, 0 }; // !
+static const unsigned char helvetica10_34[] = { 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 80, 80, 0, 0, 0 }; // "
+static const unsigned char helvetica10_35[] = { 6, 0, 0, 0, 80, 80, 248, 40, 124, 40, 40, 0, 0, 0, 0 }; // #
+static const unsigned char helvetica10_36[] = { 6, 0, 0, 32, 112, 168, 40, 112, 160, 168, 112, 32, 0, 0, 0 }; // $
+static const unsigned char helvetica10_37[] = { 9, 0, 0, 0, 0, 0, 0, 38, 0, 41, 0, 22, 0, 16, 0, 8, 0, 104, 0, 148, 0, 100, 0, 0, 0, 0, 0, 0, 0 }; // %
+static const unsigned char helvetica10_38[] = { 8, 0, 0, 0, 50, 76, 76, 82, 48, 40, 40, 16, 0, 0, 0 }; // &
+static const unsigned char helvetica10_39[] = { 3, 0, 0, 0, 0, 0, 0, 0, 0, 64, 32, 32, 0, 0, 0 }; // '
+static const unsigned char helvetica10_40[] = { 4, 0, 32, 64, 64, 128, 128, 128, 128, 64, 64, 32, 0, 0, 0 }; // (
+static const unsigned char helvetica10_41[] = { 4, 0, 64, 32, 32, 16, 16, 16, 16, 32, 32, 64, 0, 0, 0 }; // )
+static const unsigned char helvetica10_42[] = { 4, 0, 0, 0, 0, 0, 0, 0, 0, 160, 64, 160, 0, 0, 0 }; // *
+static const unsigned char helvetica10_43[] = { 6, 0, 0, 0, 0, 32, 32, 248, 32, 32, 0, 0, 0, 0, 0 }; // +
+static const unsigned char helvetica10_44[] = { 3, 0, 128, 64, 64, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // ,
+static const unsigned char helvetica10_45[] = { 7, 0, 0, 0, 0, 0, 0, 124, 0, 0, 0, 0, 0, 0, 0 }; // -
+static const unsigned char helvetica10_46[] = { 3, 0, 0, 0, 64, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // .
+static const unsigned char helvetica10_47[] = { 3, 0, 0, 0, 128, 128, 64, 64, 64, 64, 32, 32, 0, 0, 0 }; // /
+static const unsigned char helvetica10_48[] = { 6, 0, 0, 0, 112, 136, 136, 136, 136, 136, 136, 112, 0, 0, 0 }; // 0
+static const unsigned char helvetica10_49[] = { 6, 0, 0, 0, 32, 32, 32, 32, 32, 32, 96, 32, 0, 0, 0 }; // 1
+static const unsigned char helvetica10_50[] = { 6, 0, 0, 0, 248, 128, 64, 48, 8, 8, 136, 112, 0, 0, 0 }; // 2
+static const unsigned char helvetica10_51[] = { 6, 0, 0, 0, 112, 136, 8, 8, 48, 8, 136, 112, 0, 0, 0 }; // 3
+static const unsigned char helvetica10_52[] = { 6, 0, 0, 0, 16, 16, 248, 144, 80, 80, 48, 16, 0, 0, 0 }; // 4
+static const unsigned char helvetica10_53[] = { 6, 0, 0, 0, 112, 136, 8, 8, 240, 128, 128, 248, 0, 0, 0 }; // 5
+static const unsigned char helvetica10_54[] = { 6, 0, 0, 0, 112, 136, 136, 200, 176, 128, 136, 112, 0, 0, 0 }; // 6
+static const unsigned char helvetica10_55[] = { 6, 0, 0, 0, 64, 64, 32, 32, 16, 16, 8, 248, 0, 0, 0 }; // 7
+static const unsigned char helvetica10_56[] = { 6, 0, 0, 0, 112, 136, 136, 136, 112, 136, 136, 112, 0, 0, 0 }; // 8
+static const unsigned char helvetica10_57[] = { 6, 0, 0, 0, 112, 136, 8, 104, 152, 136, 136, 112, 0, 0, 0 }; // 9
+static const unsigned char helvetica10_58[] = { 3, 0, 0, 0, 64, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0 }; // :
+static const unsigned char helvetica10_59[] = { 3, 0, 128, 64, 64, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0 }; // ;
+static const unsigned char helvetica10_60[] = { 6, 0, 0, 0, 0, 16, 32, 64, 32, 16, 0, 0, 0, 0, 0 }; // <
+static const unsigned char helvetica10_61[] = { 5, 0, 0, 0, 0, 0, 240, 0, 240, 0, 0, 0, 0, 0, 0 }; // =
+static const unsigned char helvetica10_62[] = { 6, 0, 0, 0, 0, 64, 32, 16, 32, 64, 0, 0, 0, 0, 0 }; // >
+static const unsigned char helvetica10_63[] = { 6, 0, 0, 0, 32, 0, 32, 32, 16, 8, 72, 48, 0, 0, 0 }; // ?
+static const unsigned char helvetica10_64[] = { 11, 0, 0, 62, 0, 64, 0, 155, 0, 164, 128, 164, 128, 162, 64, 146, 64, 77, 64, 32, 128, 31, 0, 0, 0, 0, 0, 0, 0 }; // @
+static const unsigned char helvetica10_65[] = { 7, 0, 0, 0, 130, 130, 124, 68, 40, 40, 16, 16, 0, 0, 0 }; // A
+static const unsigned char helvetica10_66[] = { 7, 0, 0, 0, 120, 68, 68, 68, 120, 68, 68, 120, 0, 0, 0 }; // B
+static const unsigned char helvetica10_67[] = { 8, 0, 0, 0, 60, 66, 64, 64, 64, 64, 66, 60, 0, 0, 0 }; // C
+static const unsigned char helvetica10_68[] = { 8, 0, 0, 0, 120, 68, 66, 66, 66, 66, 68, 120, 0, 0, 0 }; // D
+static const unsigned char helvetica10_69[] = { 7, 0, 0, 0, 124, 64, 64, 64, 124, 64, 64, 124, 0, 0, 0 }; // E
+static const unsigned char helvetica10_70[] = { 6, 0, 0, 0, 64, 64, 64, 64, 120, 64, 64, 124, 0, 0, 0 }; // F
+static const unsigned char helvetica10_71[] = { 8, 0, 0, 0, 58, 70, 66, 70, 64, 64, 66, 60, 0, 0, 0 }; // G
+static const unsigned char helvetica10_72[] = { 8, 0, 0, 0, 66, 66, 66, 66, 126, 66, 66, 66, 0, 0, 0 }; // H
+static const unsigned char helvetica10_73[] = { 3, 0, 0, 0, 64, 64, 64, 64, 64, 64, 64, 64, 0, 0, 0 }; // I
+static const unsigned char helvetica10_74[] = { 5, 0, 0, 0, 96, 144, 16, 16, 16, 16, 16, 16, 0, 0, 0 }; // J
+static const unsigned char helvetica10_75[] = { 7, 0, 0, 0, 68, 68, 72, 72, 112, 80, 72, 68, 0, 0, 0 }; // K
+static const unsigned char helvetica10_76[] = { 6, 0, 0, 0, 120, 64, 64, 64, 64, 64, 64, 64, 0, 0, 0 }; // L
+static const unsigned char helvetica10_77[] = { 9, 0, 0, 0, 0, 0, 0, 73, 0, 73, 0, 73, 0, 85, 0, 85, 0, 99, 0, 99, 0, 65, 0, 0, 0, 0, 0, 0, 0 }; // M
+static const unsigned char helvetica10_78[] = { 8, 0, 0, 0, 70, 70, 74, 74, 82, 82, 98, 98, 0, 0, 0 }; // N
+static const unsigned char helvetica10_79[] = { 8, 0, 0, 0, 60, 66, 66, 66, 66, 66, 66, 60, 0, 0, 0 }; // O
+static const unsigned char helvetica10_80[] = { 7, 0, 0, 0, 64, 64, 64, 64, 120, 68, 68, 120, 0, 0, 0 }; // P
+static const unsigned char helvetica10_81[] = { 8, 0, 0, 1, 62, 70, 74, 66, 66, 66, 66, 60, 0, 0, 0 }; // Q
+static const unsigned char helvetica10_82[] = { 7, 0, 0, 0, 68, 68, 68, 68, 120, 68, 68, 120, 0, 0, 0 }; // R
+static const unsigned char helvetica10_83[] = { 7, 0, 0, 0, 56, 68, 68, 4, 56, 64, 68, 56, 0, 0, 0 }; // S
+static const unsigned char helvetica10_84[] = { 5, 0, 0, 0, 32, 32, 32, 32, 32, 32, 32, 248, 0, 0, 0 }; // T
+static const unsigned char helvetica10_85[] = { 8, 0, 0, 0, 60, 66, 66, 66, 66, 66, 66, 66, 0, 0, 0 }; // U
+static const unsigned char helvetica10_86[] = { 7, 0, 0, 0, 16, 40, 40, 68, 68, 68, 130, 130, 0, 0, 0 }; // V
+static const unsigned char helvetica10_87[] = { 9, 0, 0, 0, 0, 0, 0, 34, 0, 34, 0, 34, 0, 85, 0, 73, 0, 73, 0, 136, 128, 136, 128, 0, 0, 0, 0, 0, 0 }; // W
+static const unsigned char helvetica10_88[] = { 7, 0, 0, 0, 68, 68, 40, 40, 16, 40, 68, 68, 0, 0, 0 }; // X
+static const unsigned char helvetica10_89[] = { 7, 0, 0, 0, 16, 16, 16, 40, 40, 68, 68, 130, 0, 0, 0 }; // Y
+static const unsigned char helvetica10_90[] = { 7, 0, 0, 0, 124, 64, 32, 16, 16, 8, 4, 124, 0, 0, 0 }; // Z
+static const unsigned char helvetica10_91[] = { 3, 0, 96, 64, 64, 64, 64, 64, 64, 64, 64, 96, 0, 0, 0 }; // [
+static const unsigned char helvetica10_92[] = { 3, 0, 0, 0, 32, 32, 64, 64, 64, 64, 128, 128, 0, 0, 0 }; // backslash
+static const unsigned char helvetica10_93[] = { 3, 0, 192, 64, 64, 64, 64, 64, 64, 64, 64, 192, 0, 0, 0 }; // ]
+static const unsigned char helvetica10_94[] = { 6, 0, 0, 0, 0, 0, 0, 136, 80, 80, 32, 32, 0, 0, 0 }; // ^
+static const unsigned char helvetica10_95[] = { 6, 0, 252, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // _
+static const unsigned char helvetica10_96[] = { 3, 0, 0, 0, 0, 0, 0, 0, 0, 63, 64, 32, 0, 0, 0 }; // `
+static const unsigned char helvetica10_97[] = { 5, 0, 0, 0, 104, 144, 144, 112, 16, 224, 0, 0, 0, 0, 0 }; // a
+static const unsigned char helvetica10_98[] = { 6, 0, 0, 0, 176, 200, 136, 136, 200, 176, 128, 128, 0, 0, 0 }; // b
+static const unsigned char helvetica10_99[] = { 5, 0, 0, 0, 96, 144, 128, 128, 144, 96, 0, 0, 0, 0, 0 }; // c
+static const unsigned char helvetica10_100[] = { 6, 0, 0, 0, 104, 152, 136, 136, 152, 104, 8, 8, 0, 0, 0 }; // d
+static const unsigned char helvetica10_101[] = { 5, 0, 0, 0, 96, 144, 128, 240, 144, 96, 0, 0, 0, 0, 0 }; // e
+static const unsigned char helvetica10_102[] = { 4, 0, 0, 0, 64, 64, 64, 64, 64, 224, 64, 48, 0, 0, 0 }; // f
+static const unsigned char helvetica10_103[] = { 6, 0, 112, 8, 104, 152, 136, 136, 152, 104, 0, 0, 0, 0, 0 }; // g
+static const unsigned char helvetica10_104[] = { 6, 0, 0, 0, 136, 136, 136, 136, 200, 176, 128, 128, 0, 0, 0 }; // h
+static const unsigned char helvetica10_105[] = { 2, 0, 0, 0, 128, 128, 128, 128, 128, 128, 0, 128, 0, 0, 0 }; // i
+static const unsigned char helvetica10_106[] = { 2, 0, 0, 128, 128, 128, 128, 128, 128, 128, 0, 128, 0, 0, 0 }; // j
+static const unsigned char helvetica10_107[] = { 5, 0, 0, 0, 144, 144, 160, 192, 160, 144, 128, 128, 0, 0, 0 }; // k
+static const unsigned char helvetica10_108[] = { 2, 0, 0, 0, 128, 128, 128, 128, 128, 128, 128, 128, 0, 0, 0 }; // l
+static const unsigned char helvetica10_109[] = { 8, 0, 0, 0, 146, 146, 146, 146, 146, 236, 0, 0, 0, 0, 0 }; // m
+static const unsigned char helvetica10_110[] = { 6, 0, 0, 0, 136, 136, 136, 136, 200, 176, 0, 0, 0, 0, 0 }; // n
+static const unsigned char helvetica10_111[] = { 6, 0, 0, 0, 112, 136, 136, 136, 136, 112, 0, 0, 0, 0, 0 }; // o
+static const unsigned char helvetica10_112[] = { 6, 0, 128, 128, 176, 200, 136, 136, 200, 176, 0, 0, 0, 0, 0 }; // p
+static const unsigned char helvetica10_113[] = { 6, 0, 8, 8, 104, 152, 136, 136, 152, 104, 0, 0, 0, 0, 0 }; // q
+static const unsigned char helvetica10_114[] = { 4, 0, 0, 0, 128, 128, 128, 128, 192, 160, 0, 0, 0, 0, 0 }; // r
+static const unsigned char helvetica10_115[] = { 5, 0, 0, 0, 96, 144, 16, 96, 144, 96, 0, 0, 0, 0, 0 }; // s
+static const unsigned char helvetica10_116[] = { 4, 0, 0, 0, 96, 64, 64, 64, 64, 224, 64, 64, 0, 0, 0 }; // t
+static const unsigned char helvetica10_117[] = { 5, 0, 0, 0, 112, 144, 144, 144, 144, 144, 0, 0, 0, 0, 0 }; // u
+static const unsigned char helvetica10_118[] = { 6, 0, 0, 0, 32, 32, 80, 80, 136, 136, 0, 0, 0, 0, 0 }; // v
+static const unsigned char helvetica10_119[] = { 8, 0, 0, 0, 40, 40, 84, 84, 146, 146, 0, 0, 0, 0, 0 }; // w
+static const unsigned char helvetica10_120[] = { 6, 0, 0, 0, 136, 136, 80, 32, 80, 136, 0, 0, 0, 0, 0 }; // x
+static const unsigned char helvetica10_121[] = { 5, 0, 128, 64, 64, 96, 160, 160, 144, 144, 0, 0, 0, 0, 0 }; // y
+static const unsigned char helvetica10_122[] = { 5, 0, 0, 0, 240, 128, 64, 32, 16, 240, 0, 0, 0, 0, 0 }; // z
+static const unsigned char helvetica10_123[] = { 3, 0, 32, 64, 64, 64, 64, 128, 64, 64, 64, 32, 0, 0, 0 }; // {
+static const unsigned char helvetica10_124[] = { 3, 0, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 0, 0, 0 }; // |
+static const unsigned char helvetica10_125[] = { 3, 0, 128, 64, 64, 64, 64, 32, 64, 64, 64, 128, 0, 0, 0 }; // }
+static const unsigned char helvetica10_126[] = { 7, 0, 0, 0, 0, 0, 0, 152, 100, 0, 0, 0, 0, 0, 0 }; // ~
+
+const BitmapFont fontHelvetica10 = {
+	14, 3,
+	{
+		helvetica10_32, helvetica10_33, helvetica10_34, helvetica10_35, helvetica10_36, helvetica10_37, helvetica10_38, helvetica10_39,
+		helvetica10_40, helvetica10_41, helvetica10_42, helvetica10_43, helvetica10_44, helvetica10_45, helvetica10_46, helvetica10_47,
+		helvetica10_48, helvetica10_49, helvetica10_50, helvetica10_51, helvetica10_52, helvetica10_53, helvetica10_54, helvetica10_55,
+		helvetica10_56, helvetica10_57, helvetica10_58, helvetica10_59, helvetica10_60, helvetica10_61, helvetica10_62, helvetica10_63,
+		helvetica10_64, helvetica10_65, helvetica10_66, helvetica10_67, helvetica10_68, helvetica10_69, helvetica10_70, helvetica10_71,
+		helvetica10_72, helvetica10_73, helvetica10_74, helvetica10_75, helvetica10_76, helvetica10_77, helvetica10_78, helvetica10_79,
+		helvetica10_80, helvetica10_81, helvetica10_82, helvetica10_83, helvetica10_84, helvetica10_85, helvetica10_86, helvetica10_87,
+		helvetica10_88, helvetica10_89, helvetica10_90, helvetica10_91, helvetica10_92, helvetica10_93, helvetica10_94, helvetica10_95,
+		helvetica10_96, helvetica10_97, helvetica10_98, helvetica10_99, helvetica10_100, helvetica10_101, helvetica10_102, helvetica10_103,
+		helvetica10_104, helvetica10_105, helvetica10_106, helvetica10_107, helvetica10_108, helvetica10_109, helvetica10_110, helvetica10_111,
+		helvetica10_112, helvetica10_113, helvetica10_114, helvetica10_115, helvetica10_116, helvetica10_117, helvetica10_118, helvetica10_119,
+		helvetica10_120, helvetica10_121, helvetica10_122, helvetica10_123, helvetica10_124, helvetica10_125, helvetica10_126
+	}
+};
+
+static const unsigned char helvetica18_32[] = { 5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; //  
+static const unsigned char helvetica18_33[] = { 6, 0, 0, 0, 0, 0, 48, 48, 0, 0, 32, 32, 48, 48, 48, 48, 48, 48, 48, 48, 0, 0, 0, 0 }; // !
+static const unsigned char helvetica18_34[] = { 5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 144, 144, 216, 216, 216, 0, 0, 0, 0 }; // "
+static const unsigned char helvetica18_35[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 36, 0, 36, 0, 36, 0, 255, 128, 255, 128, 18, 0, 18, 0, 18, 0, 127, 192, 127, 192, 9, 0, 9, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // #
+static const unsigned char helvetica18_36[] = { 10, 0, 0, 0, 0, 0, 0, 4, 0, 4, 0, 31, 0, 63, 128, 117, 192, 100, 192, 4, 192, 7, 128, 31, 0, 60, 0, 116, 0, 100, 0, 101, 128, 63, 128, 31, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // $
+static const unsigned char helvetica18_37[] = { 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 60, 12, 126, 6, 102, 6, 102, 3, 126, 3, 60, 1, 128, 61, 128, 126, 192, 102, 192, 102, 96, 126, 96, 60, 48, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // %
+static const unsigned char helvetica18_38[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 56, 63, 112, 115, 224, 97, 192, 97, 224, 99, 96, 119, 96, 62, 0, 30, 0, 51, 0, 51, 0, 63, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // &
+static const unsigned char helvetica18_39[] = { 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 64, 32, 32, 96, 96, 0, 0, 0, 0 }; // '
+static const unsigned char helvetica18_40[] = { 6, 0, 8, 24, 48, 48, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 48, 48, 24, 8, 0, 0, 0, 0 }; // (
+static const unsigned char helvetica18_41[] = { 6, 0, 64, 96, 48, 48, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 48, 48, 96, 64, 0, 0, 0, 0 }; // )
+static const unsigned char helvetica18_42[] = { 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 68, 56, 56, 124, 16, 16, 0, 0, 0, 0 }; // *
+static const unsigned char helvetica18_43[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 0, 12, 0, 12, 0, 12, 0, 127, 128, 127, 128, 12, 0, 12, 0, 12, 0, 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // +
+static const unsigned char helvetica18_44[] = { 5, 0, 0, 64, 32, 32, 96, 96, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // ,
+static const unsigned char helvetica18_45[] = { 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 128, 127, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // -
+static const unsigned char helvetica18_46[] = { 5, 0, 0, 0, 0, 0, 96, 96, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // .
+static const unsigned char helvetica18_47[] = { 5, 0, 0, 0, 0, 0, 192, 192, 64, 64, 96, 96, 32, 32, 48, 48, 16, 16, 24, 24, 0, 0, 0, 0 }; // /
+static const unsigned char helvetica18_48[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 63, 0, 51, 0, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 51, 0, 63, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 0
+static const unsigned char helvetica18_49[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 62, 0, 62, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 1
+static const unsigned char helvetica18_50[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 128, 127, 128, 96, 0, 112, 0, 56, 0, 28, 0, 14, 0, 7, 0, 3, 128, 1, 128, 97, 128, 127, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 2
+static const unsigned char helvetica18_51[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 63, 0, 99, 128, 97, 128, 1, 128, 3, 128, 15, 0, 14, 0, 3, 0, 97, 128, 97, 128, 63, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 3
+static const unsigned char helvetica18_52[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 128, 1, 128, 1, 128, 127, 192, 127, 192, 97, 128, 49, 128, 25, 128, 25, 128, 13, 128, 7, 128, 3, 128, 1, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 4
+static const unsigned char helvetica18_53[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 62, 0, 127, 0, 99, 128, 97, 128, 1, 128, 1, 128, 99, 128, 127, 0, 126, 0, 96, 0, 96, 0, 127, 0, 127, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 5
+static const unsigned char helvetica18_54[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 63, 0, 113, 128, 97, 128, 97, 128, 97, 128, 127, 0, 110, 0, 96, 0, 96, 0, 49, 128, 63, 128, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 6
+static const unsigned char helvetica18_55[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 48, 0, 48, 0, 24, 0, 24, 0, 24, 0, 12, 0, 12, 0, 6, 0, 6, 0, 3, 0, 1, 128, 127, 128, 127, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 7
+static const unsigned char helvetica18_56[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 63, 0, 115, 128, 97, 128, 97, 128, 51, 0, 63, 0, 51, 0, 97, 128, 97, 128, 115, 128, 63, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 8
+static const unsigned char helvetica18_57[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 62, 0, 127, 0, 99, 0, 1, 128, 1, 128, 29, 128, 63, 128, 97, 128, 97, 128, 97, 128, 99, 128, 63, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // 9
+static const unsigned char helvetica18_58[] = { 5, 0, 0, 0, 0, 0, 96, 96, 0, 0, 0, 0, 0, 0, 96, 96, 0, 0, 0, 0, 0, 0, 0, 0 }; // :
+static const unsigned char helvetica18_59[] = { 5, 0, 0, 64, 32, 32, 96, 96, 0, 0, 0, 0, 0, 0, 96, 96, 0, 0, 0, 0, 0, 0, 0, 0 }; // ;
+static const unsigned char helvetica18_60[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 128, 7, 128, 30, 0, 56, 0, 96, 0, 56, 0, 30, 0, 7, 128, 1, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // <
+static const unsigned char helvetica18_61[] = { 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 63, 128, 63, 128, 0, 0, 0, 0, 63, 128, 63, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // =
+static const unsigned char helvetica18_62[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 0, 120, 0, 30, 0, 7, 0, 1, 128, 7, 0, 30, 0, 120, 0, 96, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // >
+static const unsigned char helvetica18_63[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 0, 24, 0, 0, 0, 0, 0, 24, 0, 24, 0, 24, 0, 28, 0, 14, 0, 7, 0, 99, 0, 99, 0, 127, 0, 62, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // ?
+static const unsigned char helvetica18_64[] = { 18, 0, 0, 0, 0, 0, 0, 3, 240, 0, 15, 248, 0, 28, 0, 0, 56, 0, 0, 51, 184, 0, 103, 252, 0, 102, 102, 0, 102, 51, 0, 102, 51, 0, 102, 49, 128, 99, 25, 128, 51, 185, 128, 49, 217, 128, 24, 3, 0, 14, 7, 0, 7, 254, 0, 1, 248, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // @
+static const unsigned char helvetica18_65[] = { 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 192, 48, 192, 48, 96, 96, 96, 96, 127, 224, 63, 192, 48, 192, 48, 192, 25, 128, 25, 128, 15, 0, 15, 0, 6, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // A
+static const unsigned char helvetica18_66[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 192, 127, 224, 96, 112, 96, 48, 96, 48, 96, 112, 127, 224, 127, 192, 96, 192, 96, 96, 96, 96, 96, 224, 127, 192, 127, 128, 0, 0, 0, 0, 0, 0, 0, 0 }; // B
+static const unsigned char helvetica18_67[] = { 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 192, 31, 240, 56, 56, 48, 24, 112, 0, 96, 0, 96, 0, 96, 0, 96, 0, 112, 0, 48, 24, 56, 56, 31, 240, 7, 192, 0, 0, 0, 0, 0, 0, 0, 0 }; // C
+static const unsigned char helvetica18_68[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 128, 127, 192, 96, 224, 96, 96, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 96, 96, 224, 127, 192, 127, 128, 0, 0, 0, 0, 0, 0, 0, 0 }; // D
+static const unsigned char helvetica18_69[] = { 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 192, 127, 192, 96, 0, 96, 0, 96, 0, 96, 0, 127, 128, 127, 128, 96, 0, 96, 0, 96, 0, 96, 0, 127, 192, 127, 192, 0, 0, 0, 0, 0, 0, 0, 0 }; // E
+static const unsigned char helvetica18_70[] = { 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 127, 128, 127, 128, 96, 0, 96, 0, 96, 0, 96, 0, 127, 192, 127, 192, 0, 0, 0, 0, 0, 0, 0, 0 }; // F
+static const unsigned char helvetica18_71[] = { 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 216, 31, 248, 56, 56, 48, 24, 112, 24, 96, 248, 96, 248, 96, 0, 96, 0, 112, 24, 48, 24, 56, 56, 31, 240, 7, 192, 0, 0, 0, 0, 0, 0, 0, 0 }; // G
+static const unsigned char helvetica18_72[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 127, 240, 127, 240, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 0, 0, 0, 0, 0, 0, 0, 0 }; // H
+static const unsigned char helvetica18_73[] = { 6, 0, 0, 0, 0, 0, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 0, 0, 0, 0 }; // I
+static const unsigned char helvetica18_74[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 63, 0, 115, 128, 97, 128, 97, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 0, 0, 0, 0, 0, 0, 0, 0 }; // J
+static const unsigned char helvetica18_75[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 56, 96, 112, 96, 224, 97, 192, 99, 128, 103, 0, 126, 0, 124, 0, 110, 0, 103, 0, 99, 128, 97, 192, 96, 224, 96, 112, 0, 0, 0, 0, 0, 0, 0, 0 }; // K
+static const unsigned char helvetica18_76[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 128, 127, 128, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // L
+static const unsigned char helvetica18_77[] = { 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 97, 134, 97, 134, 99, 198, 98, 70, 102, 102, 102, 102, 108, 54, 108, 54, 120, 30, 120, 30, 112, 14, 112, 14, 96, 6, 96, 6, 0, 0, 0, 0, 0, 0, 0, 0 }; // M
+static const unsigned char helvetica18_78[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 48, 96, 112, 96, 240, 96, 240, 97, 176, 99, 48, 99, 48, 102, 48, 102, 48, 108, 48, 120, 48, 120, 48, 112, 48, 96, 48, 0, 0, 0, 0, 0, 0, 0, 0 }; // N
+static const unsigned char helvetica18_79[] = { 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 192, 31, 240, 56, 56, 48, 24, 112, 28, 96, 12, 96, 12, 96, 12, 96, 12, 112, 28, 48, 24, 56, 56, 31, 240, 7, 192, 0, 0, 0, 0, 0, 0, 0, 0 }; // O
+static const unsigned char helvetica18_80[] = { 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 96, 0, 127, 128, 127, 192, 96, 224, 96, 96, 96, 96, 96, 224, 127, 192, 127, 128, 0, 0, 0, 0, 0, 0, 0, 0 }; // P
+static const unsigned char helvetica18_81[] = { 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 7, 216, 31, 240, 56, 120, 48, 216, 112, 220, 96, 12, 96, 12, 96, 12, 96, 12, 112, 28, 48, 24, 56, 56, 31, 240, 7, 192, 0, 0, 0, 0, 0, 0, 0, 0 }; // Q
+static const unsigned char helvetica18_82[] = { 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 96, 96, 96, 96, 96, 96, 96, 96, 192, 96, 192, 127, 128, 127, 192, 96, 224, 96, 96, 96, 96, 96, 224, 127, 192, 127, 128, 0, 0, 0, 0, 0, 0, 0, 0 }; // R
+static const unsigned char helvetica18_83[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 31, 128, 63, 224, 112, 112, 96, 48, 0, 48, 0, 112, 1, 224, 15, 128, 62, 0, 112, 0, 96, 48, 112, 112, 63, 224, 15, 128, 0, 0, 0, 0, 0, 0, 0, 0 }; // S
+static const unsigned char helvetica18_84[] = { 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 6, 0, 127, 224, 127, 224, 0, 0, 0, 0, 0, 0, 0, 0 }; // T
+static const unsigned char helvetica18_85[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 15, 128, 63, 224, 48, 96, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 96, 48, 0, 0, 0, 0, 0, 0, 0, 0 }; // U
+static const unsigned char helvetica18_86[] = { 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 7, 128, 7, 128, 12, 192, 12, 192, 12, 192, 24, 96, 24, 96, 24, 96, 48, 48, 48, 48, 48, 48, 96, 24, 96, 24, 0, 0, 0, 0, 0, 0, 0, 0 }; // V
+static const unsigned char helvetica18_87[] = { 18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 12, 0, 12, 12, 0, 14, 28, 0, 26, 22, 0, 27, 54, 0, 27, 54, 0, 51, 51, 0, 51, 51, 0, 49, 35, 0, 49, 227, 0, 97, 225, 128, 96, 193, 128, 96, 193, 128, 96, 193, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // W
+static const unsigned char helvetica18_88[] = { 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 48, 112, 112, 48, 96, 56, 224, 24, 192, 13, 128, 7, 0, 7, 0, 13, 128, 24, 192, 56, 224, 48, 96, 112, 112, 96, 48, 0, 0, 0, 0, 0, 0, 0, 0 }; // X
+static const unsigned char helvetica18_89[] = { 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 3, 0, 3, 0, 3, 0, 3, 0, 3, 0, 7, 128, 12, 192, 24, 96, 24, 96, 48, 48, 48, 48, 96, 24, 96, 24, 0, 0, 0, 0, 0, 0, 0, 0 }; // Y
+static const unsigned char helvetica18_90[] = { 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 224, 127, 224, 96, 0, 48, 0, 24, 0, 12, 0, 14, 0, 6, 0, 3, 0, 1, 128, 0, 192, 0, 96, 127, 224, 127, 224, 0, 0, 0, 0, 0, 0, 0, 0 }; // Z
+static const unsigned char helvetica18_91[] = { 5, 0, 120, 120, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 120, 120, 0, 0, 0, 0 }; // [
+static const unsigned char helvetica18_92[] = { 5, 0, 0, 0, 0, 0, 24, 24, 16, 16, 48, 48, 32, 32, 96, 96, 64, 64, 192, 192, 0, 0, 0, 0 }; // backslash
+static const unsigned char helvetica18_93[] = { 5, 0, 240, 240, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 240, 240, 0, 0, 0, 0 }; // ]
+static const unsigned char helvetica18_94[] = { 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 65, 0, 99, 0, 54, 0, 28, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // ^
+static const unsigned char helvetica18_95[] = { 10, 0, 0, 255, 192, 255, 192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // _
+static const unsigned char helvetica18_96[] = { 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 96, 64, 64, 32, 0, 0, 0, 0 }; // `
+static const unsigned char helvetica18_97[] = { 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 59, 0, 119, 0, 99, 0, 99, 0, 115, 0, 63, 0, 7, 0, 99, 0, 119, 0, 62, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // a
+static const unsigned char helvetica18_98[] = { 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 111, 0, 127, 128, 113, 128, 96, 192, 96, 192, 96, 192, 96, 192, 113, 128, 127, 128, 111, 0, 96, 0, 96, 0, 96, 0, 96, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // b
+static const unsigned char helvetica18_99[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 31, 0, 63, 128, 49, 128, 96, 0, 96, 0, 96, 0, 96, 0, 49, 128, 63, 128, 31, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // c
+static const unsigned char helvetica18_100[] = { 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 192, 63, 192, 49, 192, 96, 192, 96, 192, 96, 192, 96, 192, 49, 192, 63, 192, 30, 192, 0, 192, 0, 192, 0, 192, 0, 192, 0, 0, 0, 0, 0, 0, 0, 0 }; // d
+static const unsigned char helvetica18_101[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 63, 128, 113, 128, 96, 0, 96, 0, 127, 128, 97, 128, 97, 128, 63, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // e
+static const unsigned char helvetica18_102[] = { 6, 0, 0, 0, 0, 0, 48, 48, 48, 48, 48, 48, 48, 48, 252, 252, 48, 48, 60, 28, 0, 0, 0, 0 }; // f
+static const unsigned char helvetica18_103[] = { 11, 0, 0, 14, 0, 63, 128, 49, 128, 0, 192, 30, 192, 63, 192, 49, 192, 96, 192, 96, 192, 96, 192, 96, 192, 48, 192, 63, 192, 30, 192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // g
+static const unsigned char helvetica18_104[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 113, 128, 111, 128, 103, 0, 96, 0, 96, 0, 96, 0, 96, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // h
+static const unsigned char helvetica18_105[] = { 4, 0, 0, 0, 0, 0, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 0, 0, 96, 96, 0, 0, 0, 0 }; // i
+static const unsigned char helvetica18_106[] = { 4, 0, 192, 224, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 0, 0, 96, 96, 0, 0, 0, 0 }; // j
+static const unsigned char helvetica18_107[] = { 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 99, 128, 99, 0, 103, 0, 102, 0, 108, 0, 124, 0, 120, 0, 108, 0, 102, 0, 99, 0, 96, 0, 96, 0, 96, 0, 96, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // k
+static const unsigned char helvetica18_108[] = { 4, 0, 0, 0, 0, 0, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 0, 0, 0, 0 }; // l
+static const unsigned char helvetica18_109[] = { 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 99, 24, 99, 24, 99, 24, 99, 24, 99, 24, 99, 24, 99, 24, 115, 152, 111, 120, 102, 48, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // m
+static const unsigned char helvetica18_110[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 113, 128, 111, 128, 103, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // n
+static const unsigned char helvetica18_111[] = { 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 31, 0, 63, 128, 49, 128, 96, 192, 96, 192, 96, 192, 96, 192, 49, 128, 63, 128, 31, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // o
+static const unsigned char helvetica18_112[] = { 11, 0, 0, 96, 0, 96, 0, 96, 0, 96, 0, 111, 0, 127, 128, 113, 128, 96, 192, 96, 192, 96, 192, 96, 192, 113, 128, 127, 128, 111, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // p
+static const unsigned char helvetica18_113[] = { 11, 0, 0, 0, 192, 0, 192, 0, 192, 0, 192, 30, 192, 63, 192, 49, 192, 96, 192, 96, 192, 96, 192, 96, 192, 49, 192, 63, 192, 30, 192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // q
+static const unsigned char helvetica18_114[] = { 6, 0, 0, 0, 0, 0, 96, 96, 96, 96, 96, 96, 96, 112, 108, 108, 0, 0, 0, 0, 0, 0, 0, 0 }; // r
+static const unsigned char helvetica18_115[] = { 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 60, 0, 126, 0, 99, 0, 3, 0, 31, 0, 126, 0, 96, 0, 99, 0, 63, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // s
+static const unsigned char helvetica18_116[] = { 6, 0, 0, 0, 0, 0, 24, 56, 48, 48, 48, 48, 48, 48, 252, 252, 48, 48, 48, 0, 0, 0, 0, 0 }; // t
+static const unsigned char helvetica18_117[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 57, 128, 125, 128, 99, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 97, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // u
+static const unsigned char helvetica18_118[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 0, 12, 0, 30, 0, 18, 0, 51, 0, 51, 0, 51, 0, 97, 128, 97, 128, 97, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // v
+static const unsigned char helvetica18_119[] = { 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 192, 12, 192, 28, 224, 20, 160, 52, 176, 51, 48, 51, 48, 99, 24, 99, 24, 99, 24, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // w
+static const unsigned char helvetica18_120[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 97, 128, 115, 128, 51, 0, 30, 0, 12, 0, 12, 0, 30, 0, 51, 0, 115, 128, 97, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // x
+static const unsigned char helvetica18_121[] = { 10, 0, 0, 56, 0, 56, 0, 12, 0, 12, 0, 12, 0, 12, 0, 30, 0, 18, 0, 51, 0, 51, 0, 51, 0, 97, 128, 97, 128, 97, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // y
+static const unsigned char helvetica18_122[] = { 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 0, 127, 0, 96, 0, 48, 0, 24, 0, 12, 0, 6, 0, 3, 0, 127, 0, 127, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // z
+static const unsigned char helvetica18_123[] = { 6, 0, 12, 24, 48, 48, 48, 48, 48, 48, 96, 192, 96, 48, 48, 48, 48, 48, 24, 12, 0, 0, 0, 0 }; // {
+static const unsigned char helvetica18_124[] = { 4, 0, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 0, 0, 0, 0 }; // |
+static const unsigned char helvetica18_125[] = { 6, 0, 192, 96, 48, 48, 48, 48, 48, 48, 24, 12, 24, 48, 48, 48, 48, 48, 96, 192, 0, 0, 0, 0 }; // }
+static const unsigned char helvetica18_126[] = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 102, 0, 63, 0, 25, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // ~
+
+const BitmapFont fontHelvetica18 = {
+	23, 5,
+	{
+		helvetica18_32, helvetica18_33, helvetica18_34, helvetica18_35, helvetica18_36, helvetica18_37, helvetica18_38, helvetica18_39,
+		helvetica18_40, helvetica18_41, helvetica18_42, helvetica18_43, helvetica18_44, helvetica18_45, helvetica18_46, helvetica18_47,
+		helvetica18_48, helvetica18_49, helvetica18_50, helvetica18_51, helvetica18_52, helvetica18_53, helvetica18_54, helvetica18_55,
+		helvetica18_56, helvetica18_57, helvetica18_58, helvetica18_59, helvetica18_60, helvetica18_61, helvetica18_62, helvetica18_63,
+		helvetica18_64, helvetica18_65, helvetica18_66, helvetica18_67, helvetica18_68, helvetica18_69, helvetica18_70, helvetica18_71,
+		helvetica18_72, helvetica18_73, helvetica18_74, helvetica18_75, helvetica18_76, helvetica18_77, helvetica18_78, helvetica18_79,
+		helvetica18_80, helvetica18_81, helvetica18_82, helvetica18_83, helvetica18_84, helvetica18_85, helvetica18_86, helvetica18_87,
+		helvetica18_88, helvetica18_89, helvetica18_90, helvetica18_91, helvetica18_92, helvetica18_93, helvetica18_94, helvetica18_95,
+		helvetica18_96, helvetica18_97, helvetica18_98, helvetica18_99, helvetica18_100, helvetica18_101, helvetica18_102, helvetica18_103,
+		helvetica18_104, helvetica18_105, helvetica18_106, helvetica18_107, helvetica18_108, helvetica18_109, helvetica18_110, helvetica18_111,
+		helvetica18_112, helvetica18_113, helvetica18_114, helvetica18_115, helvetica18_116, helvetica18_117, helvetica18_118, helvetica18_119,
+		helvetica18_120, helvetica18_121, helvetica18_122, helvetica18_123, helvetica18_124, helvetica18_125, helvetica18_126
+	}
+};
@@ -0,0 +1,69 @@
+#include "frameclock.h"
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+FrameClock::FrameClock(double tickSeconds, int maxTicksPerFrame)
+	: tick(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(tickSeconds))), maxTicks(maxTicksPerFrame) {
+}
+
+void FrameClock::start() {
+#ifdef _WIN32
+	// sleeps are rounded to the scheduler's 15.6ms by default, coarser than a frame
+	static bool fineTimer = timeBeginPeriod(1) == TIMERR_NOERROR;
+	(void)fineTimer;
+#endif
+	last = Clock::now();
+	nextFrame = last;
+	accumulated = Clock::duration::zero();
+	dropped = Clock::duration::zero();
+}
+
+int FrameClock::ticksDue() {
+	Clock::time_point now = Clock::now();
+	accumulated += now - last;
+	last = now;
+
+	int ticks = (int)(accumulated / tick);
+	if (ticks > maxTicks) {
+		dropped += accumulated - tick * maxTicks;
+		accumulated = tick * maxTicks;
+		ticks = maxTicks;
+	}
+	accumulated -= tick * ticks;
+	return ticks;
+}
+
+float FrameClock::alpha() const {
+	return (float)((double)accumulated.count() / tick.count());
+}
+
+void FrameClock::waitForFrame(double framesPerSecond) {
+	if (framesPerSecond <= 0)
+		return;
+
+	// frames are due at fixed times rather than a fixed gap after the last one, so the
+	// rate holds even though each sleep wakes a little late - a frame that ran long
+	// starts the schedule again from now rather than hurrying to catch up
+	Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond));
+	Clock::time_point now = Clock::now();
+	nextFrame += period;
+	if (nextFrame < now)
+		nextFrame = now;
+	else
+		std::this_thread::sleep_until(nextFrame);
+}
+
+void FrameClock::waitForTick() {
+	std::this_thread::sleep_until(last + (tick - accumulated));
+}
+
+double FrameClock::droppedSeconds() const {
+	return std::chrono::duration<double>(dropped).count();
+}
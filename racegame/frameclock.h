@@ -0,0 +1,48 @@
+#pragma once
+
+// turns real time into fixed simulation ticks - each frame asks how many ticks are due
+// since the last one, runs them, then draws the cars part way between the last two ticks
+// by however much time is left over. time is kept in the monotonic clock's own integer
+// units, so a long session doesn't drift away from the wall clock
+
+#include <chrono>
+
+class FrameClock {
+public:
+	// at most maxTicks are run for one frame - after a stall (a breakpoint, dragging the
+	// window) the rest of the time is dropped, so the game slows for a moment rather than
+	// running hundreds of ticks to catch up and falling further behind
+	explicit FrameClock(double tickSeconds, int maxTicks = 25);
+
+	// starts counting from now
+	void start();
+
+	// the whole ticks due since the last call - what's left over carries to the next
+	int ticksDue();
+
+	// how far real time has got through the tick after the last one run, 0 to 1 - the
+	// cars are drawn this far from where they were to where they are
+	float alpha() const;
+
+	// sleeps until the next frame is due at the given rate, 0 for no limit
+	void waitForFrame(double framesPerSecond);
+
+	// sleeps until the next tick is due
+	void waitForTick();
+
+	typedef std::chrono::steady_clock Clock;
+
+	// the real time the ticks run so far have reached - the last call to ticksDue(), less
+	// what was left over
+	Clock::time_point reached() const { return last - accumulated; }
+
+	// real time thrown away by the catch-up limit
+	double droppedSeconds() const;
+
+private:
+	Clock::duration tick;
+	int maxTicks;
+	Clock::time_point last, nextFrame;
+	Clock::duration accumulated = Clock::duration::zero();
+	Clock::duration dropped = Clock::duration::zero();
+};
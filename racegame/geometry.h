@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// line (track and car drawing) geometry
+struct point {
+	float x, y;
+};
+
+struct edge {
+	point p1, p2;
+};
+
+// the four sides of a car's oriented bounding box: left, top, right, bottom
+typedef std::array<edge, 4> CarEdges;
+
+// a run of values somebody else owns - a vector, or an array mapped in from a file
+template <typename T> struct ArrayView {
+	const T *data = nullptr;
+	size_t count = 0;
+
+	ArrayView() {}
+	ArrayView(const T *values, size_t n) : data(values), count(n) {}
+	ArrayView(const std::vector<T> &values) : data(values.data()), count(values.size()) {}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	const T &operator[](size_t i) const { return data[i]; }
+	const T *begin() const { return data; }
+	const T *end() const { return data + count; }
+};
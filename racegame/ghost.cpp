@@ -0,0 +1,282 @@
+#include "ghost.h"
+#include "simulation.h"
+#include "track.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+// what a ghost file starts with - the steps follow
+struct GhostHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t trackHash;
+	uint32_t sampleTicks;
+	float positionStep, rotationStep;
+	int32_t ticks;
+	GhostPose start;
+	uint32_t stepBytes;
+};
+
+static const char ghostMagic[4] = { 'R', 'G', 'G', 'H' };
+// 2 - the track hash takes in the waypoints, sector lines and steering too
+static const uint32_t ghostVersion = 2;
+
+constexpr float Ghost::positionStep;
+constexpr float Ghost::rotationStep;
+
+float GhostLap::seconds() const {
+	return ticks * tickSeconds;
+}
+
+// the next sample along from p - encoding and playback both go through this, so they
+// land on exactly the same floats and rounding never adds up over a lap
+static GhostPose stepped(const GhostPose &p, const int8_t *step) {
+	return { p.x + step[0] * Ghost::positionStep, p.y + step[1] * Ghost::positionStep, p.rot + step[2] * Ghost::rotationStep };
+}
+
+static int8_t quantise(float steps) {
+	float rounded = roundf(steps);
+	if (rounded > 127)
+		return 127;
+	if (rounded < -127)
+		return -127;
+	return (int8_t)rounded;
+}
+
+Ghost::Ghost(float maxLapSeconds) {
+	size_t ticks = 1;
+	while (ticks < (size_t)(maxLapSeconds / tickSeconds))
+		ticks *= 2;
+	ring.resize(ticks);
+	ringMask = ticks - 1;
+
+	// a lap as long as the ring, so keeping one only ever swaps buffers
+	bestLap.steps.reserve(ticks / sampleTicks * 3);
+	spareLap.steps.reserve(ticks / sampleTicks * 3);
+}
+
+void Ghost::restart() {
+	recorded = 0;
+	lapStart = 0;
+	onLap = false;
+	lapsSeen = 0;
+	shown = false;
+}
+
+void Ghost::update(const Race &race, int car) {
+	const CarPool &cars = race.cars;
+	const LapTimers &laps = race.laps;
+	if ((size_t)car >= cars.size()) {
+		shown = false;
+		return;
+	}
+
+	// a lap finished this tick - it ran up to the tick before, this one starts the next
+	if (onLap && laps.completed[car] > lapsSeen) {
+		long ticks = recorded - lapStart;
+		if (ticks <= (long)ring.size() && (bestLap.empty() || ticks < bestLap.ticks))
+			keepLap(ticks);
+		lapStart = recorded;
+	}
+	lapsSeen = laps.completed[car];
+
+	// the first lap starts when the car first reaches the line
+	if (!onLap && laps.started[car]) {
+		onLap = true;
+		lapStart = recorded;
+	}
+	if (!onLap) {
+		shown = false;
+		return;
+	}
+
+	ring[recorded & ringMask] = { cars.pos_x[car], cars.pos_y[car], cars.rot[car] };
+	recorded++;
+	play(recorded - 1 - lapStart);
+}
+
+// squeezes the lap just finished into the spare and makes it the best - each sample is
+// stepped to from where the last one was decoded to, not where the car really was, so a
+// step that had to be clamped is made up by the ones after it
+void Ghost::keepLap(long ticks) {
+	GhostLap &lap = spareLap;
+	lap.ticks = ticks;
+	lap.start = ring[lapStart & ringMask];
+	lap.steps.clear();
+
+	GhostPose at = lap.start;
+	for (long t = sampleTicks; t < ticks; t += sampleTicks) {
+		const GhostPose &p = ring[(lapStart + t) & ringMask];
+
+		// rot wraps at +/-360, so turns are taken the short way round
+		float turn = p.rot - at.rot;
+		while (turn > 180)
+			turn -= 360;
+		while (turn < -180)
+			turn += 360;
+
+		int8_t step[3] = { quantise((p.x - at.x) / positionStep), quantise((p.y - at.y) / positionStep), quantise(turn / rotationStep) };
+		lap.steps.insert(lap.steps.end(), step, step + 3);
+		at = stepped(at, step);
+	}
+
+	std::swap(bestLap, spareLap);
+	rewind();
+}
+
+void Ghost::rewind() {
+	cursor = 0;
+	from = bestLap.start;
+	to = bestLap.steps.empty() ? from : stepped(from, &bestLap.steps[0]);
+}
+
+// the ghost's pose a number of ticks into the lap, between the samples either side
+void Ghost::play(long lapTick) {
+	bool wasShown = shown;
+	shown = !bestLap.empty() && lapTick < bestLap.ticks;
+	if (!shown)
+		return;
+
+	size_t sample = (size_t)(lapTick / sampleTicks);
+	if (sample < cursor)
+		rewind();
+	while (cursor < sample) {
+		cursor++;
+		from = to;
+		if (cursor * 3 < bestLap.steps.size())
+			to = stepped(from, &bestLap.steps[cursor * 3]);
+	}
+
+	float f = (float)(lapTick % sampleTicks) / sampleTicks;
+	before = now;
+	now = { from.x + (to.x - from.x) * f, from.y + (to.y - from.y) * f, from.rot + (to.rot - from.rot) * f };
+	if (!wasShown || lapTick == 0)
+		before = now;
+}
+
+bool Ghost::save(const std::string &path, const Track &track, std::string &error) const {
+	if (bestLap.empty()) {
+		error = "no lap to save";
+		return false;
+	}
+
+	GhostHeader header = {};
+	memcpy(header.magic, ghostMagic, sizeof(header.magic));
+	header.version = ghostVersion;
+	header.trackHash = hashTrack(track);
+	header.sampleTicks = sampleTicks;
+	header.positionStep = positionStep;
+	header.rotationStep = rotationStep;
+	header.ticks = (int32_t)bestLap.ticks;
+	header.start = bestLap.start;
+	header.stepBytes = (uint32_t)bestLap.steps.size();
+
+	FILE *out = fopen(path.c_str(), "wb");
+	if (!out) {
+		error = "can't write " + path;
+		return false;
+	}
+	bool written = fwrite(&header, sizeof(header), 1, out) == 1 &&
+		fwrite(bestLap.steps.data(), 1, bestLap.steps.size(), out) == bestLap.steps.size();
+	written = fclose(out) == 0 && written;
+	if (!written)
+		error = "couldn't write all of " + path;
+	return written;
+}
+
+bool Ghost::load(const std::string &path, const Track &track, std::string &error) {
+	FILE *in = fopen(path.c_str(), "rb");
+	if (!in) {
+		error = "can't open " + path;
+		return false;
+	}
+
+	// the sizes have to agree with each other, and with the ring, before anything is read by them
+	GhostHeader header;
+	bool valid = fread(&header, sizeof(header), 1, in) == 1 && memcmp(header.magic, ghostMagic, sizeof(header.magic)) == 0 &&
+		header.version == ghostVersion && header.sampleTicks == (uint32_t)sampleTicks &&
+		header.positionStep == positionStep && header.rotationStep == rotationStep &&
+		header.ticks > 0 && header.ticks <= (int32_t)ring.size() && header.stepBytes == (uint32_t)(header.ticks - 1) / sampleTicks * 3;
+	if (valid) {
+		spareLap.steps.resize(header.stepBytes);
+		valid = fread(spareLap.steps.data(), 1, spareLap.steps.size(), in) == spareLap.steps.size();
+	}
+	fclose(in);
+
+	if (!valid) {
+		error = path + " isn't a ghost from this version of the game";
+		return false;
+	}
+	if (header.trackHash != hashTrack(track)) {
+		error = path + " was driven on a different version of the track";
+		return false;
+	}
+
+	spareLap.ticks = header.ticks;
+	spareLap.start = header.start;
+	std::swap(bestLap, spareLap);
+	rewind();
+	return true;
+}
+
+std::string ghostPath(const std::string &trackPath) {
+	const char *extensions[] = { ".track", ".trk" };
+	for (const char *extension : extensions) {
+		size_t length = strlen(extension);
+		if (trackPath.size() > length && trackPath.compare(trackPath.size() - length, length, extension) == 0)
+			return trackPath.substr(0, trackPath.size() - length) + ".ghost";
+	}
+	return trackPath + ".ghost";
+}
+
+// the window's ghost is made the first time it's wanted, so headless runs never pay for its ring
+static Ghost &windowGhost() {
+	static Ghost ghost;
+	return ghost;
+}
+
+static std::string windowGhostPath;
+static long savedTicks = 0;	// the lap already in the file, so an unbeaten ghost isn't written again
+
+static void saveGhostAtExit() {
+	Ghost &ghost = windowGhost();
+	race.ghost = nullptr;
+	if (ghost.best().empty() || ghost.best().ticks == savedTicks)
+		return;
+
+	std::string error;
+	if (ghost.save(windowGhostPath, track, error))
+		std::cout << "kept a ghost of a " << ghost.best().seconds() << "s lap in " << windowGhostPath << " (" << ghost.best().steps.size()
+			<< " bytes of steps)" << std::endl;
+	else
+		std::cout << "couldn't save ghost: " << error << std::endl;
+}
+
+void startGhost(const std::string &trackPath) {
+	Ghost &ghost = windowGhost();
+	windowGhostPath = ghostPath(trackPath);
+
+	// no file just means no lap has been kept yet
+	std::string error;
+	FILE *existing = fopen(windowGhostPath.c_str(), "rb");
+	if (existing) {
+		fclose(existing);
+		if (ghost.load(windowGhostPath, track, error)) {
+			savedTicks = ghost.best().ticks;
+			std::cout << "racing the ghost of a " << ghost.best().seconds() << "s lap" << std::endl;
+		}
+		else
+			std::cout << "couldn't load ghost: " << error << std::endl;
+	}
+
+	ghost.restart();
+	race.ghost = &ghost;
+
+	static bool registered = false;
+	if (!registered) {
+		atexit(saveGhostAtExit);
+		registered = true;
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+// the ghost of the player's best lap - every tick of the lap under way goes into a ring
+// of poses allocated up front, and when a lap beats the best it's squeezed down to a
+// pose every few ticks, each stored as byte sized steps from the one before. a minute's
+// lap comes to about 4.5KB. the ghost then drives that lap alongside the player on later
+// laps, and is kept next to the track between sessions
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Race;
+class Track;
+
+// where the ghost is on one tick
+struct GhostPose {
+	float x, y, rot;
+};
+
+// one lap of a car's path
+struct GhostLap {
+	long ticks = 0;				// 0 when there's no lap
+	GhostPose start = {};		// the pose on the line
+	std::vector<int8_t> steps;	// x, y and rot steps, one set per sample after the first
+
+	float seconds() const;
+	size_t samples() const { return ticks > 0 ? 1 + steps.size() / 3 : 0; }
+	bool empty() const { return ticks == 0; }
+};
+
+class Ghost {
+public:
+	// a sample is kept every sampleTicks - 25 a second - and moves are kept to 1/512 of a
+	// unit and turns to 1/32 of a degree. a byte's step covers a car at nearly twice top
+	// speed, and anything faster (being shoved) is caught up over the next few samples
+	static const int sampleTicks = 8;
+	static constexpr float positionStep = 1.0f / 512;
+	static constexpr float rotationStep = 1.0f / 32;
+
+	// laps longer than maxLapSeconds are never kept - everything a lap needs is allocated
+	// here, so following one never touches the heap
+	explicit Ghost(float maxLapSeconds = 300);
+
+	// starts following a new race, keeping the best lap
+	void restart();
+
+	// follows the given car through the tick just run - call after the lap timer
+	void update(const Race &race, int car);
+
+	// where the ghost is this tick and was last tick, valid when visible() - it is shown
+	// while the car is on a lap and the best lap hasn't finished yet
+	bool visible() const { return shown; }
+	const GhostPose &pose() const { return now; }
+	const GhostPose &previousPose() const { return before; }
+
+	const GhostLap &best() const { return bestLap; }
+
+	// keeps the best lap in a file, tied to the track it was driven on
+	bool save(const std::string &path, const Track &track, std::string &error) const;
+	bool load(const std::string &path, const Track &track, std::string &error);
+
+private:
+	// the poses of the lap under way, one a tick - lapStart counts ticks since restart()
+	// the same way as recorded does, so the lap is everything between them
+	std::vector<GhostPose> ring;
+	size_t ringMask;
+	long recorded = 0, lapStart = 0;
+	bool onLap = false;
+	int lapsSeen = 0;
+
+	GhostLap bestLap, spareLap;
+
+	// playing the best lap back - the samples either side of the tick the lap is on,
+	// worked out a step at a time as the lap goes
+	size_t cursor = 0;
+	GhostPose from = {}, to = {};
+	GhostPose now = {}, before = {};
+	bool shown = false;
+
+	void keepLap(long ticks);
+	void rewind();
+	void play(long lapTick);
+};
+
+// the window's ghost - loads any kept for the track, follows the player in the window's
+// race and saves a new best at exit
+void startGhost(const std::string &trackPath);
+
+// where a track's ghost is kept
+std::string ghostPath(const std::string &trackPath);
@@ -0,0 +1,19 @@
+#pragma once
+
+// pulls in OpenGL and GLUT - buffer objects are past OpenGL 1.1, so on windows they
+// come through GLEW (call glewInit() once a window exists), elsewhere the system
+// headers declare them directly
+#ifdef _WIN32
+#include <glew.h> // include the GLEW header file
+#ifdef _MSC_VER
+#pragma comment(lib, "glew32.lib")
+#endif
+#else
+#define GL_GLEXT_PROTOTYPES
+#endif
+
+#include <freeglut.h> // include the GLUT header file
+
+// draw calls issued so far - the renderer bumps this on every glDrawArrays/glEnd, so
+// it can be reset at the start of a frame and read at the end
+extern int drawCalls;
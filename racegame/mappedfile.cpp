@@ -0,0 +1,105 @@
+#include "mappedfile.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void MappedFile::swap(MappedFile &other) {
+	std::swap(bytes, other.bytes);
+	std::swap(length, other.length);
+#ifdef _WIN32
+	std::swap(file, other.file);
+	std::swap(mapping, other.mapping);
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char *path) {
+	close();
+
+	HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(handle);
+		return false;
+	}
+
+	HANDLE view = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!view) {
+		CloseHandle(handle);
+		return false;
+	}
+
+	bytes = (const unsigned char *)MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+	if (!bytes) {
+		CloseHandle(view);
+		CloseHandle(handle);
+		return false;
+	}
+
+	file = handle;
+	mapping = view;
+	length = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::close() {
+	if (bytes)
+		UnmapViewOfFile(bytes);
+	if (mapping)
+		CloseHandle(mapping);
+	if (file)
+		CloseHandle(file);
+
+	bytes = nullptr;
+	length = 0;
+	file = mapping = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const char *path) {
+	close();
+
+	int fd = ::open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	// the mapping holds its own reference to the file, so the descriptor can go now
+	void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED)
+		return false;
+
+	bytes = (const unsigned char *)view;
+	length = (size_t)info.st_size;
+	return true;
+}
+
+void MappedFile::close() {
+	if (bytes)
+		munmap((void *)bytes, length);
+
+	bytes = nullptr;
+	length = 0;
+}
+
+#endif
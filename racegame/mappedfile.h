@@ -0,0 +1,35 @@
+#pragma once
+
+// read-only view of a whole file through the os's memory mapping, so loading costs no
+// reads or copies up front - pages come in as they're first touched
+
+#include <cstddef>
+
+class MappedFile {
+public:
+	MappedFile() {}
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	// maps the file, closing whatever was mapped before - returns false if it can't be
+	// opened or is empty
+	bool open(const char *path);
+	void close();
+
+	// exchanges mappings with another, leaving both mapped where they were
+	void swap(MappedFile &other);
+
+	bool isOpen() const { return bytes != nullptr; }
+	const unsigned char *data() const { return bytes; }
+	size_t size() const { return length; }
+
+private:
+	const unsigned char *bytes = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	void *file = nullptr;		// HANDLEs, kept as void * so windows.h stays out of the header
+	void *mapping = nullptr;
+#endif
+};
@@ -0,0 +1,224 @@
+#include "profile.h"
+
+#ifdef RACEGAME_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+struct ProfileEvent {
+	const char *name;
+	int64_t start, end;
+};
+
+// a single producer, single consumer ring - only its own thread writes to it and only
+// profileCollect reads from it, so the two indices are all that needs to be shared. when
+// the reader falls behind, new timings are dropped rather than waiting
+struct ProfileRing {
+	static const size_t capacity = 1 << 14;
+	ProfileEvent events[capacity];
+	std::atomic<size_t> head{ 0 };		// next slot to write, only the owning thread moves it
+	std::atomic<size_t> tail{ 0 };		// next slot to read, only the collector moves it
+	std::atomic<size_t> dropped{ 0 };
+	int thread = 0;
+
+	void push(const ProfileEvent &e) {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) == capacity) {
+			dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return;
+		}
+		events[h & (capacity - 1)] = e;
+		head.store(h + 1, std::memory_order_release);
+	}
+};
+
+// one kept timing, with the thread it came from
+struct TraceEvent {
+	const char *name;
+	int thread;
+	int64_t start, end;
+};
+
+// the last few hundred timings of one scope, for the overlay
+struct RollingWindow {
+	static const int size = 256;
+	const char *name;
+	float micros[size];
+	int count = 0, next = 0;
+};
+
+static const std::chrono::steady_clock::time_point profileStart = std::chrono::steady_clock::now();
+
+// every ring ever made - a thread's ring outlives it, so whatever it timed still gets written
+static std::mutex ringsLock;
+static std::vector<std::unique_ptr<ProfileRing>> rings;
+static thread_local ProfileRing *threadRing = nullptr;
+
+// everything collected so far - the trace is capped, a long session keeps its start
+static const size_t traceLimit = 1 << 21;
+static std::vector<TraceEvent> trace;
+static size_t traceOverflow = 0;
+static std::vector<RollingWindow> windows;
+
+int64_t profileNow() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profileStart).count();
+}
+
+void profileRecord(const char *name, int64_t start, int64_t end) {
+	if (!threadRing) {
+		std::lock_guard<std::mutex> lock(ringsLock);
+		rings.emplace_back(new ProfileRing());
+		threadRing = rings.back().get();
+		threadRing->thread = (int)rings.size() - 1;
+	}
+	threadRing->push({ name, start, end });
+}
+
+// scopes are few and names are literals, so matching the pointer first makes this cheap
+static RollingWindow &windowFor(const char *name) {
+	for (size_t i = 0; i < windows.size(); i++) {
+		if (windows[i].name == name || strcmp(windows[i].name, name) == 0)
+			return windows[i];
+	}
+	windows.push_back(RollingWindow());
+	windows.back().name = name;
+	return windows.back();
+}
+
+void profileCollect() {
+	std::lock_guard<std::mutex> lock(ringsLock);
+
+	// the whole trace is reserved up front, so collecting doesn't show up as allocations
+	// in the middle of a --check-allocs run
+	if (trace.capacity() < traceLimit)
+		trace.reserve(traceLimit);
+
+	for (size_t r = 0; r < rings.size(); r++) {
+		ProfileRing &ring = *rings[r];
+		size_t t = ring.tail.load(std::memory_order_relaxed);
+		size_t h = ring.head.load(std::memory_order_acquire);
+		for (; t != h; t++) {
+			const ProfileEvent &e = ring.events[t & (ProfileRing::capacity - 1)];
+
+			RollingWindow &window = windowFor(e.name);
+			window.micros[window.next] = (e.end - e.start) / 1000.0f;
+			window.next = (window.next + 1) % RollingWindow::size;
+			window.count = std::min(window.count + 1, RollingWindow::size);
+
+			if (trace.size() < traceLimit)
+				trace.push_back({ e.name, ring.thread, e.start, e.end });
+			else
+				traceOverflow++;
+		}
+		ring.tail.store(t, std::memory_order_release);
+	}
+}
+
+// nearest rank percentile of already sorted values
+static float percentile(const std::vector<float> &sorted, float p) {
+	size_t rank = (size_t)(p * sorted.size() + 0.999999f);
+	return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+void profileStats(std::vector<ProfileStat> &stats) {
+	stats.clear();
+	std::vector<float> sorted;
+	for (size_t i = 0; i < windows.size(); i++) {
+		const RollingWindow &window = windows[i];
+		if (window.count == 0)
+			continue;
+		sorted.assign(window.micros, window.micros + window.count);
+		std::sort(sorted.begin(), sorted.end());
+		stats.push_back({ window.name, percentile(sorted, 0.5f), percentile(sorted, 0.95f), percentile(sorted, 0.99f) });
+	}
+}
+
+// names are code literals, but quotes or backslashes would still break the json
+static void writeJsonString(FILE *out, const char *text) {
+	fputc('"', out);
+	for (const char *c = text; *c; c++) {
+		if (*c == '"' || *c == '\\')
+			fputc('\\', out);
+		fputc(*c, out);
+	}
+	fputc('"', out);
+}
+
+void writeProfile(const std::string &tracePath, const std::string &csvPath) {
+	profileCollect();
+	if (trace.empty())
+		return;
+
+	// complete events, in microseconds as the trace format wants
+	FILE *json = fopen(tracePath.c_str(), "w");
+	if (json) {
+		fputs("{\"traceEvents\":[\n", json);
+		for (size_t i = 0; i < trace.size(); i++) {
+			const TraceEvent &e = trace[i];
+			fputs("{\"name\":", json);
+			writeJsonString(json, e.name);
+			fprintf(json, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n", e.thread, e.start / 1000.0,
+				(e.end - e.start) / 1000.0, i + 1 < trace.size() ? "," : "");
+		}
+		fputs("],\"displayTimeUnit\":\"ns\"}\n", json);
+		fclose(json);
+	}
+
+	FILE *csv = fopen(csvPath.c_str(), "w");
+	if (csv) {
+		fputs("name,thread,start_us,duration_us\n", csv);
+		for (size_t i = 0; i < trace.size(); i++) {
+			const TraceEvent &e = trace[i];
+			fprintf(csv, "%s,%d,%.3f,%.3f\n", e.name, e.thread, e.start / 1000.0, (e.end - e.start) / 1000.0);
+		}
+		fclose(csv);
+	}
+
+	// a summary over the whole run, slowest typical scope first
+	struct Summary {
+		const char *name;
+		std::vector<float> micros;
+	};
+	std::vector<Summary> summaries;
+	for (size_t i = 0; i < trace.size(); i++) {
+		size_t s = 0;
+		while (s < summaries.size() && strcmp(summaries[s].name, trace[i].name) != 0)
+			s++;
+		if (s == summaries.size())
+			summaries.push_back({ trace[i].name, std::vector<float>() });
+		summaries[s].micros.push_back((trace[i].end - trace[i].start) / 1000.0f);
+	}
+	for (size_t s = 0; s < summaries.size(); s++)
+		std::sort(summaries[s].micros.begin(), summaries[s].micros.end());
+	std::sort(summaries.begin(), summaries.end(), [](const Summary &a, const Summary &b) {
+		return percentile(a.micros, 0.5f) > percentile(b.micros, 0.5f);
+	});
+
+	size_t dropped = 0;
+	for (size_t r = 0; r < rings.size(); r++)
+		dropped += rings[r]->dropped.load(std::memory_order_relaxed);
+
+	std::cout << "profile     : " << trace.size() << " timings from " << rings.size() << " threads written to " << tracePath
+		<< " and " << csvPath;
+	if (dropped > 0 || traceOverflow > 0)
+		std::cout << " (" << dropped << " dropped by full rings, " << traceOverflow << " past the trace limit)";
+	std::cout << std::endl;
+
+	char line[128];
+	snprintf(line, sizeof(line), "  %-12s %10s %10s %10s %10s", "scope", "count", "p50 us", "p95 us", "p99 us");
+	std::cout << line << std::endl;
+	for (size_t s = 0; s < summaries.size(); s++) {
+		const std::vector<float> &m = summaries[s].micros;
+		snprintf(line, sizeof(line), "  %-12s %10zu %10.2f %10.2f %10.2f", summaries[s].name, m.size(), percentile(m, 0.5f),
+			percentile(m, 0.95f), percentile(m, 0.99f));
+		std::cout << line << std::endl;
+	}
+}
+
+#endif
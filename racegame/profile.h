@@ -0,0 +1,61 @@
+#pragma once
+
+// scoped timers for finding where a tick or a frame goes - PROFILE_SCOPE("name") times
+// the rest of the enclosing block. each thread writes its timings into a ring of its own
+// with no locking, and the main thread drains them for the overlay and the dump at exit.
+// only built with RACEGAME_PROFILE defined (debug builds define it) - without it
+// PROFILE_SCOPE expands to nothing and none of this is compiled
+
+#ifdef RACEGAME_PROFILE
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// nanoseconds since the program started
+int64_t profileNow();
+
+// adds one timing to the calling thread's ring - name has to be a string literal, or
+// otherwise live for the whole program
+void profileRecord(const char *name, int64_t start, int64_t end);
+
+class ProfileScope {
+public:
+	explicit ProfileScope(const char *scopeName) : name(scopeName), start(profileNow()) {}
+	~ProfileScope() { profileRecord(name, start, profileNow()); }
+
+	ProfileScope(const ProfileScope &) = delete;
+	ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+	const char *name;
+	int64_t start;
+};
+
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_JOIN(profileScope, __LINE__)(name)
+
+// one scope's recent timings, in microseconds
+struct ProfileStat {
+	const char *name;
+	float p50, p95, p99;
+};
+
+// empties every thread's ring into the rolling window each scope keeps and the trace
+// written at exit - call from one thread only, the overlay calls it each frame
+void profileCollect();
+
+// percentiles over each scope's last few hundred timings, in the order scopes were first seen
+void profileStats(std::vector<ProfileStat> &stats);
+
+// collects anything left, then writes every timing kept as a chrome trace (load it at
+// chrome://tracing or ui.perfetto.dev) and as csv, and prints a summary - the game
+// calls this at exit
+void writeProfile(const std::string &tracePath = "profile.json", const std::string &csvPath = "profile.csv");
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+
+#endif
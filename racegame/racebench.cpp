@@ -0,0 +1,522 @@
+// racebench - times the simulation library's hot paths on their own, with no window or
+// GL context, and writes the numbers as json so runs on different commits can be
+// compared. the game's --bench-* modes print tables for a person to read, this is for
+// keeping a history
+//
+//   racebench [--json <file>] [--quick] [--only <name>] [--track <file>]
+
+#include "benchmark.h"
+#include "centreline.h"
+#include "collision.h"
+#include "raycast.h"
+#include "simulation.h"
+#include "threadpool.h"
+#include "track.h"
+#include "trackgen.h"
+#include "vectorenv.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// one number, along with what it was measured on
+struct BenchResult {
+	std::string name;
+	std::vector<std::pair<std::string, std::string>> params;	// values already written as json
+	double value;
+	std::string unit;
+};
+
+static std::vector<BenchResult> results;
+
+// how long each measurement may take - --quick cuts it, for a smoke test
+static double budgetSeconds = 0.5;
+
+// runs body in growing batches until a batch takes a tenth of the budget, then keeps the
+// fastest of five batches that size - the one least disturbed by whatever else the
+// machine was doing. returns seconds per call
+template <typename Body> static double secondsPerCall(Body body) {
+	auto timeBatch = [&](long calls) {
+		auto start = std::chrono::steady_clock::now();
+		for (long i = 0; i < calls; i++)
+			body();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	long calls = 1;
+	double seconds = timeBatch(calls);
+	while (seconds < budgetSeconds / 10 && calls < (1L << 30)) {
+		calls *= 2;
+		seconds = timeBatch(calls);
+	}
+
+	double best = seconds;
+	for (int batch = 1; batch < 5; batch++)
+		best = std::min(best, timeBatch(calls));
+	return best / calls;
+}
+
+static std::string jsonNumber(double value) {
+	char text[32];
+	snprintf(text, sizeof(text), "%.6g", value);
+	return text;
+}
+
+static std::string jsonString(const std::string &value) {
+	std::string text = "\"";
+	for (size_t i = 0; i < value.size(); i++) {
+		if (value[i] == '"' || value[i] == '\\')
+			text += '\\';
+		text += value[i];
+	}
+	return text + "\"";
+}
+
+static void report(const BenchResult &result) {
+	results.push_back(result);
+
+	std::cout << "  " << result.name;
+	for (size_t i = 0; i < result.params.size(); i++)
+		std::cout << " " << result.params[i].first << "=" << result.params[i].second;
+	std::cout << " : " << jsonNumber(result.value) << " " << result.unit << std::endl;
+}
+
+// a box's worth of isColliding - four edges against four - for pairs of neighbouring cars
+// on a ring, about a third of which touch, with every kernel this cpu can run
+static void benchCollidingPairs() {
+	float radius;
+	ringTrack(4096, radius);
+	std::vector<CarEdges> boxes = queryCars(4096, radius);
+
+	CollisionKernel original = collisionKernel();
+	CollisionKernel kernels[] = { KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX };
+	for (CollisionKernel kernel : kernels) {
+		if (!setCollisionKernel(kernel))
+			continue;
+
+		size_t next = 0;
+		volatile int hits = 0;
+		double seconds = secondsPerCall([&]() {
+			// a few pairs per call, so the loop and timer don't dominate
+			for (int i = 0; i < 16; i++) {
+				hits += isColliding(boxes[next], boxes[next + 1]);
+				if (++next == boxes.size() - 1)
+					next = 0;
+			}
+		});
+		report({ "isColliding", { { "kernel", jsonString(collisionKernelName(kernel)) } }, 16 / seconds, "pairs/s" });
+	}
+	setCollisionKernel(original);
+}
+
+// building a car's box from its pose, and fetching it from CarPool's cache once built
+static void benchCarEdges() {
+	const int count = 1024;
+	CarPool pool;
+	for (int i = 0; i < count; i++) {
+		int car = pool.add(i * 0.5f, i * -0.25f, false);
+		float heading = i * 0.37f;
+		pool.vel_x[car] = -sin(heading);
+		pool.vel_y[car] = cos(heading);
+	}
+
+	int next = 0;
+	CarEdges box;
+	volatile float sink = 0;
+	double seconds = secondsPerCall([&]() {
+		carEdgesAt(pool.pos_x[next], pool.pos_y[next], pool.vel_x[next], pool.vel_y[next], box);
+		sink += box[2].p1.x;
+		next = (next + 1) & (count - 1);
+	});
+	report({ "carEdgesAt", {}, seconds * 1e9, "ns/call" });
+
+	// every box is built before timing, so each call is a cache hit - what a tick pays
+	// for the second and later asks about a car
+	for (int i = 0; i < count; i++)
+		pool.edges(i);
+	seconds = secondsPerCall([&]() {
+		sink += pool.edges(next)[2].p1.x;
+		next = (next + 1) & (count - 1);
+	});
+	report({ "CarPool::edges", { { "cached", "true" } }, seconds * 1e9, "ns/call" });
+}
+
+// the circuits are generated from this, so every run races on the same walls
+static const unsigned trackSeed = 1;
+
+// spreads count cars evenly round the lap, nose to tail and weaving from wall to wall, all
+// driving along the road - more than the grid held are added first, as none of them stay
+// where it put them
+static void spreadAroundTrack(Race &race, int count) {
+	const Centreline &centreline = race.track->centreline();
+	CarPool &cars = race.cars;
+	while ((int)cars.size() < count)
+		cars.add(0.0f, 0.0f, false);
+	for (size_t i = 0; i < cars.size(); i++) {
+		float dir_x, dir_y;
+		point p = centreline.pointAt(centreline.length() * i / cars.size(), dir_x, dir_y);
+		float across = 3.0f * sin(i * 0.37f);
+		cars.pos_x[i] = cars.prev_x[i] = p.x + dir_y * across;
+		cars.pos_y[i] = cars.prev_y[i] = p.y - dir_x * across;
+		cars.rot[i] = cars.prev_rot[i] = atan2(-dir_x, dir_y) / piOver180;
+		cars.vel_x[i] = cars.prev_vel_x[i] = dir_x;
+		cars.vel_y[i] = cars.prev_vel_y[i] = dir_y;
+	}
+
+	// and the lap timer picks them up from where they now are, short of their first lap
+	LapTimers &laps = race.laps;
+	laps.reset(cars.size(), centreline.sectorDistances().size() + 1);
+	for (size_t i = 0; i < cars.size(); i++) {
+		laps.segment[i] = centreline.nearestSegment(cars.pos_x[i], cars.pos_y[i]);
+		laps.distance[i] = centreline.project(cars.pos_x[i], cars.pos_y[i], laps.segment[i]) - centreline.length();
+	}
+}
+
+static bool generatedCircuit(int segments, Track &circuit) {
+	TrackLayout layout = generateTrack(trackSeed, segments);
+	std::string error;
+	bool ok = circuit.build(layout, error);
+	if (!ok)
+		std::cout << "couldn't build a circuit of " << segments << " segments: " << error << std::endl;
+	return ok;
+}
+
+// making a circuit and building its grid and fields, from tens of segments to hundreds of
+// thousands - once each, since the big ones take a while
+static bool benchTrackBuild() {
+	for (int segments = 64; segments <= 32768; segments *= 8) {
+		auto start = std::chrono::steady_clock::now();
+		TrackLayout layout = generateTrack(trackSeed, segments);
+		std::chrono::duration<double, std::milli> generateTime = std::chrono::steady_clock::now() - start;
+
+		Track circuit;
+		std::string error;
+		start = std::chrono::steady_clock::now();
+		bool ok = circuit.build(layout, error);
+		std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+		if (!ok) {
+			std::cout << "couldn't build a circuit of " << segments << " segments: " << error << std::endl;
+			return false;
+		}
+
+		report({ "generateTrack", { { "segments", jsonNumber(segments) } }, generateTime.count(), "ms" });
+		report({ "Track::build", { { "segments", jsonNumber(segments) } }, buildTime.count(), "ms" });
+	}
+	return true;
+}
+
+// a whole tick - steering, physics, walls, car pairs and laps - against the number of
+// cars and the size of the track, after the race has had a second to settle
+static bool benchTicks() {
+	const int segmentCounts[] = { 256, 4096, 65536 };
+	const int carCounts[] = { 1, 10, 100, 1000 };
+
+	for (int segments : segmentCounts) {
+		Track circuit;
+		if (!generatedCircuit(segments, circuit))
+			return false;
+
+		for (int cars : carCounts) {
+			Race bench;
+			initRace(bench, circuit, cars, false, 1);
+			spreadAroundTrack(bench, cars);
+			for (int i = 0; i < 200; i++)
+				stepRace(bench);
+
+			double seconds = secondsPerCall([&]() { stepRace(bench); });
+			report({ "tick", { { "cars", jsonNumber(cars) }, { "segments", jsonNumber(segments) } }, seconds * 1e6, "us/tick" });
+		}
+	}
+	return true;
+}
+
+// the cpu cars' steering on its own, a field lookup and a cross product per car
+static bool benchSteering() {
+	const int cars = 1000;
+	Track circuit;
+	if (!generatedCircuit(4096, circuit))
+		return false;
+
+	Race bench;
+	initRace(bench, circuit, cars, false, 1);
+	spreadAroundTrack(bench, cars);
+
+	double seconds = secondsPerCall([&]() {
+		steerCpuCars(bench);
+		std::fill(bench.cars.controls.begin(), bench.cars.controls.end(), 0);
+	});
+	report({ "steerCpuCars", { { "cars", jsonNumber(cars) } }, seconds * 1e9 / cars, "ns/car" });
+	return true;
+}
+
+// a point walked twice round a loop whose waypoints repeat one, as a track file can - its
+// distance round has to keep going up past the repeat, not stick there
+static bool checkRepeatedWaypoint() {
+	std::vector<point> waypoints;
+	for (int i = 0; i < 12; i++) {
+		float angle = i * 30 * piOver180;
+		waypoints.push_back({ 20 * cosf(angle), 20 * sinf(angle) });
+		if (i == 4)
+			waypoints.push_back(waypoints.back());
+	}
+	Centreline centreline;
+	centreline.build(waypoints, { { 15, 0 }, { 25, 0 } }, EdgeSpan());
+
+	int segment = centreline.nearestSegment(20, 0);
+	float was = centreline.project(20, 0, segment);
+	for (int step = 1; step <= 1000; step++) {
+		float dir_x, dir_y;
+		point p = centreline.pointAt(step * 0.25f, dir_x, dir_y);
+		float distance = centreline.project(p.x, p.y, segment);
+		float moved = distance - was;
+		if (moved < -centreline.length() * 0.5f)
+			moved += centreline.length();
+		if (!(moved > 0)) {
+			std::cout << "FAILED: lap distance stuck at " << distance << " on a repeated waypoint" << std::endl;
+			return false;
+		}
+		was = distance;
+	}
+	return true;
+}
+
+// lap timing and race order for a big field - each car is moved along the centreline from
+// the segment it was on and the order is sorted again, with no geometry tested
+static bool benchLapTimer() {
+	if (!checkRepeatedWaypoint())
+		return false;
+
+	const int cars = 200;
+	Track circuit;
+	if (!generatedCircuit(4096, circuit))
+		return false;
+
+	Race bench;
+	initRace(bench, circuit, cars, false, 1);
+	spreadAroundTrack(bench, cars);
+	for (int i = 0; i < 200; i++)
+		stepRace(bench);
+
+	double seconds = secondsPerCall([&]() { doLapTimer(bench); });
+	report({ "doLapTimer", { { "cars", jsonNumber(cars) } }, seconds * 1e6, "us/tick" });
+	return true;
+}
+
+// training environments stepped as a batch, on one thread and then on every core - each
+// step holds the action for 4 ticks and casts 16 rays
+static bool benchEnvs() {
+	const int envs = 64;
+	Track circuit;
+	if (!generatedCircuit(4096, circuit))
+		return false;
+
+	std::vector<unsigned char> actions(envs, CONTROL_ACCELERATE);
+	for (int threads : { 1, 0 }) {
+		VectorEnvConfig config;
+		config.envs = envs;
+		config.threads = threads;
+		VectorEnv env(circuit, config);
+
+		double seconds = secondsPerCall([&]() { env.step(actions.data()); });
+		report({ "VectorEnv::step", { { "envs", jsonNumber(envs) }, { "threads", jsonNumber(threads) } }, envs / seconds, "steps/s" });
+	}
+	return true;
+}
+
+// wall sensors for a big field - a fan of 16 rays across the front of each car, with every
+// kernel this cpu can run, then split across every core. each kernel's distances are
+// checked against testing every ray against every wall first, so a fast wrong answer
+// doesn't get reported
+static bool benchRays() {
+	const int cars = 1000, rays = 16;
+	const float range = 30.0f;
+	Track circuit;
+	if (!generatedCircuit(4096, circuit))
+		return false;
+
+	Race bench;
+	initRace(bench, circuit, cars, false, 1);
+	spreadAroundTrack(bench, cars);
+
+	std::vector<point> fan;
+	for (int i = 0; i < rays; i++) {
+		float degrees = 180.0f * (0.5f - (float)i / (rays - 1));
+		fan.push_back({ -sinf(degrees * piOver180), cosf(degrees * piOver180) });
+	}
+
+	// the same sums the kernels do, on every wall, so they should agree exactly
+	std::vector<float> expected;
+	EdgeSpan walls = circuit.walls();
+	const CarPool &pool = bench.cars;
+	for (int car = 0; car < cars; car++) {
+		for (int i = 0; i < rays; i++) {
+			float vx = pool.vel_x[car], vy = pool.vel_y[car];
+			float dx = fan[i].x * vy + fan[i].y * vx, dy = -fan[i].x * vx + fan[i].y * vy;
+			expected.push_back(rayHitSegments(pool.pos_x[car], pool.pos_y[car], dx, dy, walls.data, walls.size(), range));
+		}
+	}
+
+	bool ok = true;
+	std::vector<float> distances(expected.size());
+	CollisionKernel original = collisionKernel();
+	CollisionKernel kernels[] = { KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX };
+	for (CollisionKernel kernel : kernels) {
+		if (!setCollisionKernel(kernel))
+			continue;
+
+		castCarRays(circuit.grid(), pool, 0, cars, fan, range, distances.data());
+		if (distances != expected) {
+			std::cout << "castCarRays with the " << collisionKernelName(kernel) << " kernel disagrees with testing every wall" << std::endl;
+			ok = false;
+			continue;
+		}
+
+		double seconds = secondsPerCall([&]() { castCarRays(circuit.grid(), pool, 0, cars, fan, range, distances.data()); });
+		report({ "castCarRays", { { "cars", jsonNumber(cars) }, { "rays", jsonNumber(rays) }, { "kernel", jsonString(collisionKernelName(kernel)) },
+			{ "threads", jsonNumber(1) } }, seconds * 1e6, "us/tick" });
+	}
+	setCollisionKernel(original);
+
+	// a few batches of cars a worker, each casting into its own rows
+	ThreadPool workers;
+	int batches = (int)workers.size() * 4;
+	double seconds = secondsPerCall([&]() {
+		for (int batch = 0; batch < batches; batch++) {
+			workers.submit([&, batch]() {
+				int firstCar = cars * batch / batches, lastCar = cars * (batch + 1) / batches;
+				castCarRays(circuit.grid(), pool, firstCar, lastCar - firstCar, fan, range, &distances[(size_t)firstCar * rays]);
+			});
+		}
+		workers.wait();
+	});
+	report({ "castCarRays", { { "cars", jsonNumber(cars) }, { "rays", jsonNumber(rays) }, { "kernel", jsonString(collisionKernelName(original)) },
+		{ "threads", jsonNumber(0) } }, seconds * 1e6, "us/tick" });
+	return ok;
+}
+
+// the track the wall check runs on - --track picks another
+static std::string wallTrackPath = defaultTrackPath;
+
+// the distance field's wall test against the segment test through the grid, for boxes
+// laid over the whole track - every few hundredths of a unit across the road and out
+// past its walls, every quarter unit along it, at eight headings. the field may call a
+// box over a wall a hit where no side crosses one, but it must never let off a box the
+// segment test catches. then the field's test is timed on every hundredth of the boxes
+static bool benchWallHits() {
+	Track circuit;
+	std::string error;
+	if (!circuit.load(wallTrackPath, error)) {
+		std::cout << "couldn't load " << wallTrackPath << ": " << error << std::endl;
+		return false;
+	}
+
+	const Centreline &centreline = circuit.centreline();
+	const DistanceField &field = circuit.wallDistance();
+	const TrackGrid &grid = circuit.grid();
+	std::vector<CarEdges> timed;
+	size_t tested = 0, hits = 0, missed = 0;
+	for (float along = 0; along < centreline.length(); along += 0.25f) {
+		float dir_x, dir_y;
+		point p = centreline.pointAt(along, dir_x, dir_y);
+		for (float across = -8.0f; across <= 8.0f; across += 0.05f) {
+			for (int turn = 0; turn < 8; turn++) {
+				float angle = turn * 22.5f * piOver180;
+				float vx = dir_x * cosf(angle) - dir_y * sinf(angle), vy = dir_x * sinf(angle) + dir_y * cosf(angle);
+				CarEdges box;
+				carEdgesAt(p.x + dir_y * across, p.y - dir_x * across, vx, vy, box);
+				if (grid.isColliding(box)) {
+					hits++;
+					missed += !field.isColliding(box, grid);
+				}
+				if (tested++ % 100 == 0)
+					timed.push_back(box);
+			}
+		}
+	}
+	if (missed > 0) {
+		std::cout << "FAILED: the distance field misses " << missed << " of " << hits << " boxes the segment test catches on "
+			<< wallTrackPath << std::endl;
+		return false;
+	}
+
+	size_t next = 0;
+	volatile int sink = 0;
+	double seconds = secondsPerCall([&]() {
+		sink += field.isColliding(timed[next], grid);
+		if (++next == timed.size())
+			next = 0;
+	});
+	report({ "DistanceField::isColliding", { { "boxes", jsonNumber((double)timed.size()) } }, seconds * 1e9, "ns/call" });
+	return true;
+}
+
+static bool writeJson(const std::string &path) {
+	FILE *out = fopen(path.c_str(), "w");
+	if (!out) {
+		std::cout << "couldn't write " << path << std::endl;
+		return false;
+	}
+
+	fprintf(out, "{\n  \"suite\": \"racebench\",\n  \"kernel\": %s,\n  \"budget_seconds\": %s,\n  \"results\": [\n",
+		jsonString(collisionKernelName(collisionKernel())).c_str(), jsonNumber(budgetSeconds).c_str());
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult &result = results[i];
+		fprintf(out, "    { \"name\": %s", jsonString(result.name).c_str());
+		for (size_t p = 0; p < result.params.size(); p++)
+			fprintf(out, ", %s: %s", jsonString(result.params[p].first).c_str(), result.params[p].second.c_str());
+		fprintf(out, ", \"value\": %s, \"unit\": %s }%s\n", jsonNumber(result.value).c_str(), jsonString(result.unit).c_str(),
+			i + 1 < results.size() ? "," : "");
+	}
+	fputs("  ]\n}\n", out);
+	fclose(out);
+	return true;
+}
+
+int main(int argc, char **argv) {
+	std::string jsonPath;	// --json <file> writes every result there as well
+	std::string only;		// --only <name> runs one group: collide, edges, track, tick, steering, laps, env, rays or walls
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (strcmp(argv[i], "--quick") == 0)
+			budgetSeconds = 0.05;
+		else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc)
+			only = argv[++i];
+		else if (strcmp(argv[i], "--track") == 0 && i + 1 < argc)
+			wallTrackPath = argv[++i];
+		else {
+			std::cout << "usage: racebench [--json <file>] [--quick] [--only collide|edges|track|tick|steering|laps|env|rays|walls] [--track <file>]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "racebench, collision kernel " << collisionKernelName(collisionKernel()) << std::endl;
+	bool ok = true;
+	if (only.empty() || only == "collide")
+		benchCollidingPairs();
+	if (only.empty() || only == "edges")
+		benchCarEdges();
+	if (only.empty() || only == "track")
+		ok = benchTrackBuild() && ok;
+	if (only.empty() || only == "tick")
+		ok = benchTicks() && ok;
+	if (only.empty() || only == "steering")
+		ok = benchSteering() && ok;
+	if (only.empty() || only == "laps")
+		ok = benchLapTimer() && ok;
+	if (only.empty() || only == "env")
+		ok = benchEnvs() && ok;
+	if (only.empty() || only == "rays")
+		ok = benchRays() && ok;
+	if (only.empty() || only == "walls")
+		ok = benchWallHits() && ok;
+
+	if (!jsonPath.empty() && !writeJson(jsonPath))
+		return 1;
+	return ok ? 0 : 1;
+}
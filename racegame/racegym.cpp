@@ -0,0 +1,78 @@
+#include "racegym.h"
+#include "vectorenv.h"
+#include <string>
+
+// the track lives with the environments, which only borrow it
+struct RaceGym {
+	Track track;
+	std::unique_ptr<VectorEnv> env;
+};
+
+static std::string lastError;
+
+RaceGym *racegym_create(const char *trackPath, int envs, int cpuCars, int rays, int ticksPerStep, int threads, unsigned seed) {
+	std::unique_ptr<RaceGym> gym(new RaceGym);
+	std::string error;
+	if (!gym->track.load(trackPath ? trackPath : defaultTrackPath, error)) {
+		lastError = error;
+		return nullptr;
+	}
+	if (envs < 1 || cpuCars < 0 || rays < 0 || ticksPerStep < 1) {
+		lastError = "envs and ticksPerStep have to be at least 1, cpuCars and rays at least 0";
+		return nullptr;
+	}
+
+	VectorEnvConfig config;
+	config.envs = envs;
+	config.cpuCars = cpuCars;
+	config.rays = rays;
+	config.ticksPerStep = ticksPerStep;
+	config.threads = threads;
+	config.seed = seed;
+	gym->env.reset(new VectorEnv(gym->track, config));
+	return gym.release();
+}
+
+void racegym_destroy(RaceGym *gym) {
+	delete gym;
+}
+
+const char *racegym_error(void) {
+	return lastError.c_str();
+}
+
+void racegym_set_episode(RaceGym *gym, int laps, long maxSteps) {
+	gym->env->setEpisode(laps, maxSteps);
+}
+
+int racegym_envs(const RaceGym *gym) {
+	return gym->env->envs();
+}
+
+int racegym_observation_size(const RaceGym *gym) {
+	return gym->env->observationSize();
+}
+
+const float *racegym_observations(const RaceGym *gym) {
+	return gym->env->observations();
+}
+
+const float *racegym_rewards(const RaceGym *gym) {
+	return gym->env->rewards();
+}
+
+const unsigned char *racegym_terminated(const RaceGym *gym) {
+	return gym->env->terminated();
+}
+
+const unsigned char *racegym_truncated(const RaceGym *gym) {
+	return gym->env->truncated();
+}
+
+void racegym_reset(RaceGym *gym) {
+	gym->env->reset();
+}
+
+void racegym_step(RaceGym *gym, const unsigned char *actions) {
+	gym->env->step(actions);
+}
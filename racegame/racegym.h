@@ -0,0 +1,56 @@
+#pragma once
+
+/* racegym - a C interface to VectorEnv (vectorenv.h), built as a shared library for
+   training driving policies from python or anything else with a C FFI. the observation,
+   reward and done arrays are allocated once when the environments are made and never
+   move, so a caller can wrap the pointers as arrays a single time and read each step's
+   results straight out of them - racegym.py does this with numpy and ctypes
+
+   observations are envs rows of racegym_observation_size() floats, laid out as
+   ObservationField in vectorenv.h: x, y, heading x, heading y, speed, next waypoint
+   ahead, next waypoint left, lap progress, then one distance per ray from left to right.
+   actions are one byte per environment of CONTROL_ bits: 1 accelerate, 2 brake, 4 left,
+   8 right */
+
+#ifdef _WIN32
+#define RACEGYM_API __declspec(dllexport)
+#else
+#define RACEGYM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct RaceGym RaceGym;
+
+/* loads a text or compiled track and makes envs environments on it, each with cpuCars
+   cpu cars and rays wall sensors, holding each action for ticksPerStep ticks. threads 0
+   uses one per core. returns null on failure, with racegym_error() saying why */
+RACEGYM_API RaceGym *racegym_create(const char *trackPath, int envs, int cpuCars, int rays, int ticksPerStep, int threads, unsigned seed);
+RACEGYM_API void racegym_destroy(RaceGym *gym);
+
+/* why the last racegym_create failed */
+RACEGYM_API const char *racegym_error(void);
+
+/* episodes end after this many laps, or are cut short after maxSteps steps */
+RACEGYM_API void racegym_set_episode(RaceGym *gym, int laps, long maxSteps);
+
+RACEGYM_API int racegym_envs(const RaceGym *gym);
+RACEGYM_API int racegym_observation_size(const RaceGym *gym);
+
+/* the buffers each step writes - valid until racegym_destroy */
+RACEGYM_API const float *racegym_observations(const RaceGym *gym);
+RACEGYM_API const float *racegym_rewards(const RaceGym *gym);
+RACEGYM_API const unsigned char *racegym_terminated(const RaceGym *gym);
+RACEGYM_API const unsigned char *racegym_truncated(const RaceGym *gym);
+
+/* starts every environment over */
+RACEGYM_API void racegym_reset(RaceGym *gym);
+
+/* one action per environment - environments whose episode ends start the next at once */
+RACEGYM_API void racegym_step(RaceGym *gym, const unsigned char *actions);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,95 @@
+"""racegym - batched racing environments for training driving policies.
+
+Wraps the racegym shared library (racegym.h). The observation, reward and done arrays
+are numpy views straight onto the library's buffers, made once - every step() writes
+into them in place, so nothing is copied. Copy them if they need to outlive the next step.
+
+    env = RaceGym("tracks/default.track", envs=64, rays=16)
+    actions = np.full(env.envs, ACCELERATE, dtype=np.uint8)
+    env.step(actions)
+    env.observations    # (envs, observation_size) float32
+"""
+
+import ctypes
+import os
+import sys
+
+import numpy as np
+
+# action bits, OR them together - the CONTROL_ values in carpool.h
+ACCELERATE = 1
+BRAKE = 2
+LEFT = 4
+RIGHT = 8
+
+# what each column of an observation holds, as ObservationField in vectorenv.h - RAYS
+# is the first ray, from the leftmost round to the rightmost
+X, Y, HEADING_X, HEADING_Y, SPEED, WAYPOINT_AHEAD, WAYPOINT_LEFT, PROGRESS, RAYS = range(9)
+
+
+def _load(path):
+	if path is None:
+		name = {"win32": "racegym.dll", "darwin": "libracegym.dylib"}.get(sys.platform, "libracegym.so")
+		path = os.environ.get("RACEGYM_LIBRARY", name)
+	lib = ctypes.CDLL(path)
+
+	lib.racegym_create.restype = ctypes.c_void_p
+	lib.racegym_create.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_uint]
+	lib.racegym_destroy.argtypes = [ctypes.c_void_p]
+	lib.racegym_error.restype = ctypes.c_char_p
+	lib.racegym_set_episode.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_long]
+	for name in ("racegym_envs", "racegym_observation_size"):
+		getattr(lib, name).restype = ctypes.c_int
+		getattr(lib, name).argtypes = [ctypes.c_void_p]
+	for name in ("racegym_observations", "racegym_rewards"):
+		getattr(lib, name).restype = ctypes.POINTER(ctypes.c_float)
+		getattr(lib, name).argtypes = [ctypes.c_void_p]
+	for name in ("racegym_terminated", "racegym_truncated"):
+		getattr(lib, name).restype = ctypes.POINTER(ctypes.c_ubyte)
+		getattr(lib, name).argtypes = [ctypes.c_void_p]
+	lib.racegym_reset.argtypes = [ctypes.c_void_p]
+	lib.racegym_step.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+	return lib
+
+
+class RaceGym:
+	"""envs races side by side on one track, each with one car driven by step()'s actions.
+
+	An environment whose episode ends (laps done, or max_steps reached) starts the next at
+	once, and its row of observations is the new episode's first.
+	"""
+
+	def __init__(self, track="tracks/default.track", envs=16, cpu_cars=0, rays=16, ticks_per_step=4,
+			threads=0, seed=1, laps=1, max_steps=20000, library=None):
+		self._lib = _load(library)
+		self._gym = self._lib.racegym_create(track.encode(), envs, cpu_cars, rays, ticks_per_step, threads, seed)
+		if not self._gym:
+			raise RuntimeError("racegym: " + self._lib.racegym_error().decode())
+		self._lib.racegym_set_episode(self._gym, laps, max_steps)
+
+		self.envs = self._lib.racegym_envs(self._gym)
+		self.observation_size = self._lib.racegym_observation_size(self._gym)
+		self.observations = np.ctypeslib.as_array(self._lib.racegym_observations(self._gym), (self.envs, self.observation_size))
+		self.rewards = np.ctypeslib.as_array(self._lib.racegym_rewards(self._gym), (self.envs,))
+		self.terminated = np.ctypeslib.as_array(self._lib.racegym_terminated(self._gym), (self.envs,)).view(np.bool_)
+		self.truncated = np.ctypeslib.as_array(self._lib.racegym_truncated(self._gym), (self.envs,)).view(np.bool_)
+
+	def reset(self):
+		self._lib.racegym_reset(self._gym)
+		return self.observations
+
+	def step(self, actions):
+		"""actions is one byte of action bits per environment."""
+		actions = np.ascontiguousarray(actions, dtype=np.uint8)
+		if actions.shape != (self.envs,):
+			raise ValueError("racegym: need one action per environment, %d" % self.envs)
+		self._lib.racegym_step(self._gym, actions.ctypes.data)
+		return self.observations, self.rewards, self.terminated, self.truncated
+
+	def close(self):
+		if self._gym:
+			self._lib.racegym_destroy(self._gym)
+			self._gym = None
+
+	def __del__(self):
+		self.close()
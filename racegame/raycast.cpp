@@ -0,0 +1,352 @@
+#include "raycast.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// the simd walks load an edge as four floats: p1.x, p1.y, p2.x, p2.y
+static_assert(sizeof(edge) == 4 * sizeof(float), "edge must be four packed floats");
+
+// rays castCarRays hands to castRays at a time - the fans of a handful of cars
+static const size_t rayBatch = 256;
+
+// a ray meets segment q + u * s at o + t * d when w + u * s = t * d, with w = q - o - so
+// t = cross(w, s) / den and u = cross(w, d) / den, with den = cross(d, s). as in
+// segmentsIntersect, the numerators are checked against den before anything is divided
+float rayHitSegments(float x, float y, float dx, float dy, const edge *segments, size_t count, float nearest) {
+	for (size_t j = 0; j < count; j++) {
+		const edge &e = segments[j];
+		float sx = e.p2.x - e.p1.x, sy = e.p2.y - e.p1.y;
+		float wx = e.p1.x - x, wy = e.p1.y - y;
+		float den = dx * sy - dy * sx;
+		float along = wx * sy - wy * sx;
+		float across = wx * dy - wy * dx;
+		if (den < 0) {
+			den = -den;
+			along = -along;
+			across = -across;
+		}
+		if (den > 0 && along >= 0 && across >= 0 && across <= den)
+			nearest = std::min(nearest, along / den);
+	}
+	return nearest;
+}
+
+float castRay(const TrackGrid &grid, float x, float y, float dx, float dy, float range) {
+	if (grid.storedEdges() == 0)
+		return range;
+
+	// along the ray to where it next crosses a column and a row boundary, and between
+	// boundaries after that - a ray parallel to one never crosses it
+	const float never = std::numeric_limits<float>::infinity();
+	float size = grid.cell();
+	int cx = grid.cellOf(x), cy = grid.cellOf(y);
+	int stepX = dx > 0 ? 1 : -1, stepY = dy > 0 ? 1 : -1;
+	float nextX = dx != 0 ? ((cx + (dx > 0)) * size - x) / dx : never;
+	float nextY = dy != 0 ? ((cy + (dy > 0)) * size - y) / dy : never;
+	float spanX = dx != 0 ? size / fabsf(dx) : never;
+	float spanY = dy != 0 ? size / fabsf(dy) : never;
+
+	float nearest = range;
+	for (;;) {
+		EdgeSpan edges = grid.cellEdges(cx, cy);
+		nearest = rayHitSegments(x, y, dx, dy, edges.data, edges.size(), nearest);
+
+		// an edge hit short of where the ray leaves this cell is nearer than anything in the
+		// cells beyond - every edge crossing the ray before then is stored in a cell already
+		// tested. the same goes for running out of range
+		if (nearest <= std::min(nextX, nextY))
+			return nearest;
+
+		if (nextX < nextY) {
+			cx += stepX;
+			nextX += spanX;
+		}
+		else {
+			cy += stepY;
+			nextY += spanY;
+		}
+	}
+}
+
+#ifdef RACEGAME_SSE2
+
+// the lowest set bit's index in a mask of lanes
+static inline int lowestLane(int lanes) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, (unsigned long)lanes);
+	return (int)index;
+#else
+	return __builtin_ctz((unsigned)lanes);
+#endif
+}
+
+// a packet's lanes, one ray each, and the cell each is in. a full packet is loaded
+// straight from the caller's arrays - in a short one, lanes past the last ray walk the
+// first one again, and what they find is dropped, so it needs no special case after
+struct RayLanes {
+	float x[8], y[8], dx[8], dy[8];
+	int cx[8], cy[8];
+};
+
+static void fillLanes(const float *x, const float *y, const float *dir_x, const float *dir_y, size_t count, int lanes, RayLanes &rays) {
+	for (int lane = 0; lane < lanes; lane++) {
+		size_t i = (size_t)lane < count ? lane : 0;
+		rays.x[lane] = x[i];
+		rays.y[lane] = y[i];
+		rays.dx[lane] = dir_x[i];
+		rays.dy[lane] = dir_y[i];
+	}
+}
+
+// up to four rays walked side by side, with the same sums castRay does in every lane. each
+// step takes the cells the walking lanes are in and tests every edge there against every
+// lane at once, the edge's coordinates copied across the register. a lane meeting an edge
+// from another lane's cell is no harm - any wall it crosses is at least as far as the
+// nearest one, and the walk only stops once that is found - and the rays of one car share
+// most of their cells, so a cell a few lanes are in is fetched and tested once
+static void castSse2(const TrackGrid &grid, const float *x, const float *y, const float *dir_x, const float *dir_y, size_t count, float range, float *distances) {
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	const __m128 never = _mm_set1_ps(std::numeric_limits<float>::infinity());
+
+	RayLanes rays;
+	if (count < 4) {
+		fillLanes(x, y, dir_x, dir_y, count, 4, rays);
+		x = rays.x;
+		y = rays.y;
+		dir_x = rays.dx;
+		dir_y = rays.dy;
+	}
+	__m128 ox = _mm_loadu_ps(x), oy = _mm_loadu_ps(y);
+	__m128 rx = _mm_loadu_ps(dir_x), ry = _mm_loadu_ps(dir_y);
+
+	// the cells cellOf() gives - sse2 has no floor, so the truncated value is taken down
+	// one where it landed above
+	__m128 size = _mm_set1_ps(grid.cell()), inverse = _mm_set1_ps(1.0f / grid.cell());
+	__m128 scaledX = _mm_mul_ps(ox, inverse), scaledY = _mm_mul_ps(oy, inverse);
+	__m128 cellX = _mm_cvtepi32_ps(_mm_cvttps_epi32(scaledX));
+	__m128 cellY = _mm_cvtepi32_ps(_mm_cvttps_epi32(scaledY));
+	cellX = _mm_sub_ps(cellX, _mm_and_ps(_mm_cmpgt_ps(cellX, scaledX), one));
+	cellY = _mm_sub_ps(cellY, _mm_and_ps(_mm_cmpgt_ps(cellY, scaledY), one));
+	_mm_storeu_si128((__m128i *)rays.cx, _mm_cvttps_epi32(cellX));
+	_mm_storeu_si128((__m128i *)rays.cy, _mm_cvttps_epi32(cellY));
+
+	__m128 upX = _mm_cmpgt_ps(rx, zero), upY = _mm_cmpgt_ps(ry, zero);
+	__m128 flatX = _mm_cmpeq_ps(rx, zero), flatY = _mm_cmpeq_ps(ry, zero);
+	__m128 stepX = _mm_or_ps(_mm_and_ps(upX, one), _mm_andnot_ps(upX, _mm_xor_ps(one, signBit)));
+	__m128 stepY = _mm_or_ps(_mm_and_ps(upY, one), _mm_andnot_ps(upY, _mm_xor_ps(one, signBit)));
+	__m128 nextX = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(_mm_add_ps(cellX, _mm_and_ps(upX, one)), size), ox), rx);
+	__m128 nextY = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(_mm_add_ps(cellY, _mm_and_ps(upY, one)), size), oy), ry);
+	__m128 spanX = _mm_andnot_ps(signBit, _mm_div_ps(size, rx));
+	__m128 spanY = _mm_andnot_ps(signBit, _mm_div_ps(size, ry));
+	nextX = _mm_or_ps(_mm_andnot_ps(flatX, nextX), _mm_and_ps(flatX, never));
+	nextY = _mm_or_ps(_mm_andnot_ps(flatY, nextY), _mm_and_ps(flatY, never));
+	spanX = _mm_or_ps(_mm_andnot_ps(flatX, spanX), _mm_and_ps(flatX, never));
+	spanY = _mm_or_ps(_mm_andnot_ps(flatY, spanY), _mm_and_ps(flatY, never));
+
+	__m128 nearest = _mm_set1_ps(range);
+	int walking = (1 << count) - 1;
+	while (walking) {
+		// a lane in the same cell as the lane before it leaves the fetch to that one, if it's
+		// walking - lane 0 is compared with the last lane, but always fetches
+		__m128 previousX = _mm_shuffle_ps(cellX, cellX, _MM_SHUFFLE(2, 1, 0, 3));
+		__m128 previousY = _mm_shuffle_ps(cellY, cellY, _MM_SHUFFLE(2, 1, 0, 3));
+		int repeated = _mm_movemask_ps(_mm_and_ps(_mm_cmpeq_ps(cellX, previousX), _mm_cmpeq_ps(cellY, previousY)));
+		int fetching = walking & ~(repeated & (walking << 1));
+		while (fetching) {
+			int lane = lowestLane(fetching);
+			fetching &= fetching - 1;
+
+			EdgeSpan edges = grid.cellEdges(rays.cx[lane], rays.cy[lane]);
+			for (size_t j = 0; j < edges.size(); j++) {
+				const edge &e = edges[j];
+				__m128 qx = _mm_set1_ps(e.p1.x), qy = _mm_set1_ps(e.p1.y);
+				__m128 sx = _mm_set1_ps(e.p2.x - e.p1.x), sy = _mm_set1_ps(e.p2.y - e.p1.y);
+				__m128 wx = _mm_sub_ps(qx, ox), wy = _mm_sub_ps(qy, oy);
+				__m128 den = _mm_sub_ps(_mm_mul_ps(rx, sy), _mm_mul_ps(ry, sx));
+				__m128 along = _mm_sub_ps(_mm_mul_ps(wx, sy), _mm_mul_ps(wy, sx));
+				__m128 across = _mm_sub_ps(_mm_mul_ps(wx, ry), _mm_mul_ps(wy, rx));
+
+				__m128 sign = _mm_and_ps(den, signBit);
+				den = _mm_xor_ps(den, sign);
+				along = _mm_xor_ps(along, sign);
+				across = _mm_xor_ps(across, sign);
+
+				// lanes that missed have every bit of t set, making it a nan, and min passes over
+				// a nan in its first operand. den > 0 isn't checked - a lane that passes with
+				// den = 0 has a t of infinity or nan, and is passed over too
+				__m128 miss = _mm_or_ps(_mm_cmplt_ps(_mm_min_ps(along, across), zero), _mm_cmpgt_ps(across, den));
+				__m128 t = _mm_div_ps(along, den);
+				nearest = _mm_min_ps(_mm_or_ps(t, miss), nearest);
+			}
+		}
+
+		walking &= ~_mm_movemask_ps(_mm_cmple_ps(nearest, _mm_min_ps(nextX, nextY)));
+
+		// every lane moves on, whether it's still walking or not - a lane that has stopped
+		// is never fetched again
+		__m128 alongX = _mm_cmplt_ps(nextX, nextY);
+		cellX = _mm_add_ps(cellX, _mm_and_ps(alongX, stepX));
+		cellY = _mm_add_ps(cellY, _mm_andnot_ps(alongX, stepY));
+		nextX = _mm_add_ps(nextX, _mm_and_ps(alongX, spanX));
+		nextY = _mm_add_ps(nextY, _mm_andnot_ps(alongX, spanY));
+		_mm_storeu_si128((__m128i *)rays.cx, _mm_cvttps_epi32(cellX));
+		_mm_storeu_si128((__m128i *)rays.cy, _mm_cvttps_epi32(cellY));
+	}
+
+	float found[4];
+	_mm_storeu_ps(found, nearest);
+	std::copy(found, found + count, distances);
+}
+
+#endif
+
+#ifdef RACEGAME_AVX
+
+// each lane's value moved up a lane, with lane 7's in lane 0 - rotated within each half,
+// then lane 3's swapped into lane 4 from the other half
+RACEGAME_TARGET_AVX static inline __m256 shiftLanes(__m256 v) {
+	__m256 rotated = _mm256_permute_ps(v, _MM_SHUFFLE(2, 1, 0, 3));
+	return _mm256_blend_ps(rotated, _mm256_permute2f128_ps(rotated, rotated, 0x01), 0x11);
+}
+
+// same as castSse2, eight rays at a time
+RACEGAME_TARGET_AVX static void castAvx(const TrackGrid &grid, const float *x, const float *y, const float *dir_x, const float *dir_y, size_t count, float range, float *distances) {
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+	const __m256 never = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+
+	RayLanes rays;
+	if (count < 8) {
+		fillLanes(x, y, dir_x, dir_y, count, 8, rays);
+		x = rays.x;
+		y = rays.y;
+		dir_x = rays.dx;
+		dir_y = rays.dy;
+	}
+	__m256 ox = _mm256_loadu_ps(x), oy = _mm256_loadu_ps(y);
+	__m256 rx = _mm256_loadu_ps(dir_x), ry = _mm256_loadu_ps(dir_y);
+
+	__m256 size = _mm256_set1_ps(grid.cell()), inverse = _mm256_set1_ps(1.0f / grid.cell());
+	__m256 cellX = _mm256_floor_ps(_mm256_mul_ps(ox, inverse));
+	__m256 cellY = _mm256_floor_ps(_mm256_mul_ps(oy, inverse));
+	_mm256_storeu_si256((__m256i *)rays.cx, _mm256_cvttps_epi32(cellX));
+	_mm256_storeu_si256((__m256i *)rays.cy, _mm256_cvttps_epi32(cellY));
+
+	__m256 upX = _mm256_cmp_ps(rx, zero, _CMP_GT_OQ), upY = _mm256_cmp_ps(ry, zero, _CMP_GT_OQ);
+	__m256 flatX = _mm256_cmp_ps(rx, zero, _CMP_EQ_OQ), flatY = _mm256_cmp_ps(ry, zero, _CMP_EQ_OQ);
+	__m256 stepX = _mm256_or_ps(_mm256_and_ps(upX, one), _mm256_andnot_ps(upX, _mm256_xor_ps(one, signBit)));
+	__m256 stepY = _mm256_or_ps(_mm256_and_ps(upY, one), _mm256_andnot_ps(upY, _mm256_xor_ps(one, signBit)));
+	__m256 nextX = _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(cellX, _mm256_and_ps(upX, one)), size), ox), rx);
+	__m256 nextY = _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(cellY, _mm256_and_ps(upY, one)), size), oy), ry);
+	__m256 spanX = _mm256_andnot_ps(signBit, _mm256_div_ps(size, rx));
+	__m256 spanY = _mm256_andnot_ps(signBit, _mm256_div_ps(size, ry));
+	nextX = _mm256_or_ps(_mm256_andnot_ps(flatX, nextX), _mm256_and_ps(flatX, never));
+	nextY = _mm256_or_ps(_mm256_andnot_ps(flatY, nextY), _mm256_and_ps(flatY, never));
+	spanX = _mm256_or_ps(_mm256_andnot_ps(flatX, spanX), _mm256_and_ps(flatX, never));
+	spanY = _mm256_or_ps(_mm256_andnot_ps(flatY, spanY), _mm256_and_ps(flatY, never));
+
+	__m256 nearest = _mm256_set1_ps(range);
+	int walking = (1 << count) - 1;
+	while (walking) {
+		__m256 previousX = shiftLanes(cellX), previousY = shiftLanes(cellY);
+		int repeated = _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(cellX, previousX, _CMP_EQ_OQ), _mm256_cmp_ps(cellY, previousY, _CMP_EQ_OQ)));
+		int fetching = walking & ~(repeated & (walking << 1));
+		while (fetching) {
+			int lane = lowestLane(fetching);
+			fetching &= fetching - 1;
+
+			EdgeSpan edges = grid.cellEdges(rays.cx[lane], rays.cy[lane]);
+			for (size_t j = 0; j < edges.size(); j++) {
+				const edge &e = edges[j];
+				__m256 qx = _mm256_broadcast_ss(&e.p1.x), qy = _mm256_broadcast_ss(&e.p1.y);
+				__m256 sx = _mm256_sub_ps(_mm256_broadcast_ss(&e.p2.x), qx), sy = _mm256_sub_ps(_mm256_broadcast_ss(&e.p2.y), qy);
+				__m256 wx = _mm256_sub_ps(qx, ox), wy = _mm256_sub_ps(qy, oy);
+				__m256 den = _mm256_sub_ps(_mm256_mul_ps(rx, sy), _mm256_mul_ps(ry, sx));
+				__m256 along = _mm256_sub_ps(_mm256_mul_ps(wx, sy), _mm256_mul_ps(wy, sx));
+				__m256 across = _mm256_sub_ps(_mm256_mul_ps(wx, ry), _mm256_mul_ps(wy, rx));
+
+				__m256 sign = _mm256_and_ps(den, signBit);
+				den = _mm256_xor_ps(den, sign);
+				along = _mm256_xor_ps(along, sign);
+				across = _mm256_xor_ps(across, sign);
+
+				__m256 miss = _mm256_or_ps(_mm256_cmp_ps(_mm256_min_ps(along, across), zero, _CMP_LT_OQ), _mm256_cmp_ps(across, den, _CMP_GT_OQ));
+				__m256 t = _mm256_div_ps(along, den);
+				nearest = _mm256_min_ps(_mm256_or_ps(t, miss), nearest);
+			}
+		}
+
+		walking &= ~_mm256_movemask_ps(_mm256_cmp_ps(nearest, _mm256_min_ps(nextX, nextY), _CMP_LE_OQ));
+
+		__m256 alongX = _mm256_cmp_ps(nextX, nextY, _CMP_LT_OQ);
+		cellX = _mm256_add_ps(cellX, _mm256_and_ps(alongX, stepX));
+		cellY = _mm256_add_ps(cellY, _mm256_andnot_ps(alongX, stepY));
+		nextX = _mm256_add_ps(nextX, _mm256_and_ps(alongX, spanX));
+		nextY = _mm256_add_ps(nextY, _mm256_andnot_ps(alongX, spanY));
+		_mm256_storeu_si256((__m256i *)rays.cx, _mm256_cvttps_epi32(cellX));
+		_mm256_storeu_si256((__m256i *)rays.cy, _mm256_cvttps_epi32(cellY));
+	}
+
+	float found[8];
+	_mm256_storeu_ps(found, nearest);
+	std::copy(found, found + count, distances);
+}
+
+#endif
+
+void castRays(const TrackGrid &grid, const float *x, const float *y, const float *dir_x, const float *dir_y, size_t count, float range, float *distances) {
+	if (grid.storedEdges() == 0) {
+		std::fill(distances, distances + count, range);
+		return;
+	}
+
+	switch (collisionKernel()) {
+#ifdef RACEGAME_AVX
+	case KERNEL_AVX:
+		for (size_t i = 0; i < count; i += 8)
+			castAvx(grid, x + i, y + i, dir_x + i, dir_y + i, std::min<size_t>(count - i, 8), range, distances + i);
+		return;
+#endif
+#ifdef RACEGAME_SSE2
+	case KERNEL_SSE2:
+		for (size_t i = 0; i < count; i += 4)
+			castSse2(grid, x + i, y + i, dir_x + i, dir_y + i, std::min<size_t>(count - i, 4), range, distances + i);
+		return;
+#endif
+	default:
+		for (size_t i = 0; i < count; i++)
+			distances[i] = castRay(grid, x[i], y[i], dir_x[i], dir_y[i], range);
+	}
+}
+
+void castCarRays(const TrackGrid &grid, const CarPool &cars, size_t first, size_t count, ArrayView<point> fan, float range, float *distances) {
+	float x[rayBatch], y[rayBatch], dir_x[rayBatch], dir_y[rayBatch];
+
+	// a batch at a time, each car's fan side by side in the order the distances are wanted
+	// - rays from one point walk through many of the same cells, so a packet of them shares
+	// its fetches and edge tests
+	size_t total = count * fan.size();
+	size_t car = first, ray = 0;
+	for (size_t start = 0; start < total; start += rayBatch) {
+		size_t batch = std::min(rayBatch, total - start);
+		for (size_t n = 0; n < batch; n++) {
+			// the car faces (vx, vy) rather than +y, so each ray is turned with it
+			const point &r = fan[ray];
+			float vx = cars.vel_x[car], vy = cars.vel_y[car];
+			x[n] = cars.pos_x[car];
+			y[n] = cars.pos_y[car];
+			dir_x[n] = r.x * vy + r.y * vx;
+			dir_y[n] = -r.x * vx + r.y * vy;
+			if (++ray == fan.size()) {
+				ray = 0;
+				car++;
+			}
+		}
+		castRays(grid, x, y, dir_x, dir_y, batch, range, distances + start);
+	}
+}
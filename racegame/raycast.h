@@ -0,0 +1,32 @@
+#pragma once
+
+// wall sensors - rays cast from points out to the nearest track edge. a ray walks the
+// collision grid a cell at a time from where it starts, testing only the edges stored in
+// the cells it passes through, and stops at the first cell it meets an edge in. batches
+// of rays are walked several at once, one per simd lane, with each step taking every
+// lane one cell further along its own ray and testing the edges of each lane's cell
+// against all of them
+
+#include <cstddef>
+#include "geometry.h"
+#include "collision.h"
+#include "carpool.h"
+
+// how far a ray from (x, y) along the unit direction (dx, dy) goes before crossing one of
+// the segments, if that's less than nearest - nearest otherwise. a segment the ray runs
+// exactly along is passed over, the ray meets whatever it joins
+float rayHitSegments(float x, float y, float dx, float dy, const edge *segments, size_t count, float nearest);
+
+// how far a ray from (x, y) along the unit direction (dx, dy) goes before meeting an edge
+// in the grid - range if there's none that near
+float castRay(const TrackGrid &grid, float x, float y, float dx, float dy, float range);
+
+// castRay for count rays at once, laid out structure-of-arrays like CarPool - ray i starts
+// at (x[i], y[i]) and heads along (dir_x[i], dir_y[i]). uses whichever kernel
+// collisionKernel() says, and gives the same distances whichever that is
+void castRays(const TrackGrid &grid, const float *x, const float *y, const float *dir_x, const float *dir_y, size_t count, float range, float *distances);
+
+// casts count cars' fans of rays, starting from car first - fan holds each ray's direction
+// with the car facing +y, and is turned to face wherever each car does. distances gets
+// fan.size() per car, one car after another
+void castCarRays(const TrackGrid &grid, const CarPool &cars, size_t first, size_t count, ArrayView<point> fan, float range, float *distances);
@@ -0,0 +1,543 @@
+#include "render.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include "simulation.h"
+#include "spritebatch.h"
+#include "chunkindex.h"
+#include "font.h"
+#include "profile.h"
+
+// baked textures, and the two drawn from them
+const char *textureCachePath = "textures/textures.cache";
+TextureCache textureCache;
+CachedTexture grassTexture(GL_REPEAT);
+
+// every car sprite packed into one texture, in the order of carSprites
+CachedTexture carAtlas;
+const char *carSprites[] = { "textures/Black_viper.png", "textures/Audi.png", "textures/Car.png" };
+
+// per-frame batches for cars and debug lines, built-once batches for the ground, track and waypoints
+SpriteBatch carBatch;
+SpriteBatch ghostBatch;
+LineBatch debugLines(GL_STREAM_DRAW);
+SpriteBatch groundTiles(GL_STATIC_DRAW);
+LineBatch trackLines;
+LineBatch waypointLines;
+
+// text is drawn as quads from these, the hud kept until its numbers change and the
+// coordinate labels built once with the track
+GlyphAtlas hudFont(fontHelvetica18);
+GlyphAtlas labelFont(fontHelvetica10);
+SpriteBatch hudText(GL_DYNAMIC_DRAW);
+SpriteBatch coordLabels(GL_STATIC_DRAW);
+
+// the built-once layers are cut into chunks, so only the chunks in view are drawn - the
+// labels into blocks of 8 by 8 of them, however far apart they are
+const float chunkSize = 32.0f;
+ChunkIndex groundChunks;
+ChunkIndex trackChunks;
+ChunkIndex waypointChunks;
+ChunkIndex labelChunks;
+std::vector<GLint> visibleFirsts;
+std::vector<GLsizei> visibleCounts;
+
+// width over height of the window, for working out what the camera can see
+float viewAspect = 4.0f / 3.0f;
+
+// global variables
+bool debugMode = true;	// draws bounding boses
+
+// camera positions
+float cam_x = 0;
+float cam_y = 0;
+
+float interpolation = 1.0f;
+
+// the race as of the last tick published - drawing never reads the race itself, which
+// belongs to the simulation thread
+const RaceSnapshot *scene = nullptr;
+
+void setScene(const RaceSnapshot &snapshot) {
+	scene = &snapshot;
+}
+
+// the part of the ground in view - the camera is 10 units above it, looking straight
+// down with a view 60 degrees high
+static Bounds viewBounds() {
+	float halfHeight = 10.0f * tan(30 * piOver180), halfWidth = halfHeight * viewAspect;
+	return { cam_x - halfWidth, cam_y - halfHeight, cam_x + halfWidth, cam_y + halfHeight };
+}
+
+point interpolatedPosition(int car) {
+	if (interpolation >= 1.0f)
+		return { scene->pos_x[car], scene->pos_y[car] };
+	return { scene->prev_x[car] + (scene->pos_x[car] - scene->prev_x[car]) * interpolation,
+		scene->prev_y[car] + (scene->pos_y[car] - scene->prev_y[car]) * interpolation };
+}
+
+// asks the cache for every texture the game draws, returns false if any is missing
+static bool requestTextures() {
+	textureCache.open(textureCachePath);
+
+	int grass = textureCache.requestImage("grass", "textures/grass.jpg");
+	int carSheet = textureCache.requestAtlas("cars", std::vector<std::string>(carSprites, carSprites + 3));
+	if (grass < 0 || carSheet < 0)
+		return false;
+
+	grassTexture.set(textureCache, grass);
+	carAtlas.set(textureCache, carSheet);
+	return true;
+}
+
+// texture loader - anything not baked decodes in the background from here, and nothing
+// goes to GL until it is first drawn
+int loadTextures()
+{
+	if (!requestTextures())
+		return false;
+
+	// enable blending on the alpha channel
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	return true;
+}
+
+void saveTextureCache() {
+	if (textureCache.decodedCount() > 0 && !textureCache.save())
+		std::cout << "couldn't write " << textureCachePath << std::endl;
+}
+
+int bakeTextures() {
+	if (!requestTextures()) {
+		std::cout << "missing textures, run from the directory holding textures/" << std::endl;
+		return 1;
+	}
+
+	if (!textureCache.save()) {
+		std::cout << "couldn't write " << textureCachePath << std::endl;
+		return 1;
+	}
+
+	std::cout << "baked " << textureCache.cachedCount() + textureCache.decodedCount() << " textures into "
+		<< textureCachePath << " (" << textureCache.decodedCount() << " decoded)" << std::endl;
+	return 0;
+}
+
+// the grass tiles in view, one draw
+void renderBackground(void) {
+	groundChunks.visible(viewBounds(), visibleFirsts, visibleCounts);
+	groundTiles.draw(grassTexture.texture(), visibleFirsts, visibleCounts);
+}
+
+// the best lap's ghost, see-through and under the cars - its pose is interpolated the
+// same way theirs are
+static void renderGhost(const RaceSnapshot &cars, const Bounds &view) {
+	if (!cars.ghostVisible)
+		return;
+
+	const GhostPose &from = cars.previousGhost, &to = cars.ghost;
+	float t = std::min(interpolation, 1.0f);
+	float x = from.x + (to.x - from.x) * t, y = from.y + (to.y - from.y) * t;
+	if (!view.overlaps({ x, y, x, y }))
+		return;
+	float rot = (from.rot + (to.rot - from.rot) * t) * piOver180;
+
+	CarEdges box;
+	carEdgesAt(x, y, -sin(rot), cos(rot), box);
+	point corners[4] = { box[0].p2, box[0].p1, box[1].p2, box[2].p2 };
+
+	ghostBatch.clear();
+	ghostBatch.add(corners, carAtlas.region(0));
+	glColor4f(1.0f, 1.0f, 1.0f, 0.35f);
+	ghostBatch.draw(carAtlas.texture());
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+// draws every car in view with one draw call, plus one more for the debug boxes and one
+// for the ghost
+void renderCars(void) {
+	carBatch.clear();
+	debugLines.clear();
+	if (!scene)
+		return;
+	const RaceSnapshot &cars = *scene;
+
+	// a car is in view if its middle is within a car's length of it
+	Bounds view = viewBounds();
+	float reach = carLengthHalf + carWidthHalf;
+	view = { view.minX - reach, view.minY - reach, view.maxX + reach, view.maxY + reach };
+	renderGhost(cars, view);
+
+	// player last so it is drawn on top
+	CarEdges box;
+	for (size_t i = cars.size(); i-- > 0;) {
+		int car = (int)i;
+
+		// the box gives the car's corners rotated into place - between ticks it's built
+		// part way from where the car was at the start of the last tick
+		point at = interpolatedPosition(car);
+		if (!view.overlaps({ at.x, at.y, at.x, at.y }))
+			continue;
+		float vx = cars.vel_x[car], vy = cars.vel_y[car];
+		if (interpolation < 1.0f) {
+			vx = cars.prev_vel_x[car] + (vx - cars.prev_vel_x[car]) * interpolation;
+			vy = cars.prev_vel_y[car] + (vy - cars.prev_vel_y[car]) * interpolation;
+			float length = sqrt(vx * vx + vy * vy);
+			if (length > 0) {
+				vx /= length;
+				vy /= length;
+			}
+			else {
+				vx = cars.vel_x[car];
+				vy = cars.vel_y[car];
+			}
+		}
+		carEdgesAt(at.x, at.y, vx, vy, box);
+		point corners[4] = { box[0].p2, box[0].p1, box[1].p2, box[2].p2 }; // bottom left, top left, top right, bottom right
+
+		// player gets the viper, cpu cars take turns with the others
+		size_t sprite = cars.playerControlled[car] ? 0 : 1 + car % 2;
+		carBatch.add(corners, carAtlas.region(sprite));
+
+		// draw bounding box (toggled by debugMode flag)
+		if (debugMode) {
+			for (size_t j = 0; j < box.size(); j++)
+				debugLines.add(box[j]);
+
+			// draws waypointing triangle for cpu cars - box[0] is the left side, top to bottom
+			if (!cars.playerControlled[car]) {
+				const point &target = track.waypoints()[cars.nextWaypoint[car]];
+				debugLines.add(box[0].p2, target);
+				debugLines.add(box[0].p1, target);
+			}
+		}
+	}
+
+	carBatch.draw(carAtlas.texture());
+	debugLines.draw();
+}
+
+// puts lines into a batch a chunk at a time, each line in the chunk holding its middle
+static void buildLineChunks(const std::vector<edge> &lines, LineBatch &batch, ChunkIndex &chunks) {
+	struct Placed {
+		int column, row;
+		size_t line;
+	};
+	std::vector<Placed> placed(lines.size());
+	for (size_t i = 0; i < lines.size(); i++) {
+		const edge &e = lines[i];
+		placed[i] = { chunks.column((e.p1.x + e.p2.x) / 2), chunks.row((e.p1.y + e.p2.y) / 2), i };
+	}
+	std::sort(placed.begin(), placed.end(), [](const Placed &a, const Placed &b) {
+		if (a.row != b.row)
+			return a.row < b.row;
+		return a.column != b.column ? a.column < b.column : a.line < b.line;
+	});
+
+	batch.clear();
+	for (size_t i = 0; i < placed.size();) {
+		const edge &e = lines[placed[i].line];
+		Bounds bounds = { std::min(e.p1.x, e.p2.x), std::min(e.p1.y, e.p2.y), std::max(e.p1.x, e.p2.x), std::max(e.p1.y, e.p2.y) };
+		GLint first = (GLint)batch.size() * 2;
+		size_t next = i;
+		for (; next < placed.size() && placed[next].row == placed[i].row && placed[next].column == placed[i].column; next++) {
+			const edge &line = lines[placed[next].line];
+			bounds.minX = std::min(bounds.minX, std::min(line.p1.x, line.p2.x));
+			bounds.minY = std::min(bounds.minY, std::min(line.p1.y, line.p2.y));
+			bounds.maxX = std::max(bounds.maxX, std::max(line.p1.x, line.p2.x));
+			bounds.maxY = std::max(bounds.maxY, std::max(line.p1.y, line.p2.y));
+			batch.add(line);
+		}
+		chunks.add(placed[i].column, placed[i].row, bounds, first, (GLsizei)batch.size() * 2 - first);
+		i = next;
+	}
+}
+
+// a grass tile over every chunk the walls pass through and every chunk next to one, so
+// the camera sees grass wherever a car can take it
+static void buildGround(EdgeSpan walls) {
+	groundTiles.clear();
+	groundChunks.clear(chunkSize);
+
+	// walls are walked in steps of half a chunk, so none of the chunks they cross is missed
+	std::vector<std::pair<int, int>> touched;	// row, column
+	for (size_t i = 0; i < walls.size(); i++) {
+		const edge &e = walls[i];
+		float dx = e.p2.x - e.p1.x, dy = e.p2.y - e.p1.y;
+		int steps = 1 + (int)(sqrt(dx * dx + dy * dy) / (chunkSize / 2));
+		for (int step = 0; step <= steps; step++) {
+			float x = e.p1.x + dx * step / steps, y = e.p1.y + dy * step / steps;
+			touched.push_back({ groundChunks.row(y), groundChunks.column(x) });
+		}
+	}
+	std::sort(touched.begin(), touched.end());
+	touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+	std::vector<std::pair<int, int>> tiles;
+	for (size_t i = 0; i < touched.size(); i++)
+		for (int row = -1; row <= 1; row++)
+			for (int column = -1; column <= 1; column++)
+				tiles.push_back({ touched[i].first + row, touched[i].second + column });
+	std::sort(tiles.begin(), tiles.end());
+	tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+
+	// the texture repeats every two units, as it did across the one big quad the ground
+	// used to be - a whole number of times across a tile, so each tile starts at 0
+	const AtlasRegion repeats = { 0.0f, 0.0f, chunkSize / 2, chunkSize / 2 };
+	for (size_t i = 0; i < tiles.size(); i++) {
+		float left = tiles[i].second * chunkSize, bottom = tiles[i].first * chunkSize;
+		Bounds square = { left, bottom, left + chunkSize, bottom + chunkSize };
+		point corners[4] = { { square.minX, square.minY }, { square.minX, square.maxY }, { square.maxX, square.maxY }, { square.maxX, square.minY } };
+		groundChunks.add(tiles[i].second, tiles[i].first, square, (GLint)groundTiles.size() * 4, 4);
+		groundTiles.add(corners, repeats);
+	}
+}
+
+// fills the batches that never change, including the coordinate labels - call again if the track or waypoints do
+void buildTrackLayer(void) {
+	std::vector<edge> lines;
+	EdgeSpan layers[3] = { track.walls(), track.startLines(), track.sectorLines() };
+	for (const EdgeSpan &layer : layers)
+		lines.insert(lines.end(), layer.data, layer.data + layer.size());
+	trackChunks.clear(chunkSize);
+	buildLineChunks(lines, trackLines, trackChunks);
+	buildGround(track.walls());
+
+	ArrayView<point> waypoints = track.waypoints();
+	lines.clear();
+	for (size_t i = 0; i < waypoints.size(); i++) {
+		lines.push_back({ { waypoints[i].x + 0.2f, waypoints[i].y }, { waypoints[i].x - 0.2f, waypoints[i].y } });
+		lines.push_back({ { waypoints[i].x, waypoints[i].y + 0.2f }, { waypoints[i].x, waypoints[i].y - 0.2f } });
+	}
+	waypointChunks.clear(chunkSize);
+	buildLineChunks(lines, waypointLines, waypointChunks);
+
+	// a label at every whole unit over the walls, or every second or fourth unit and so on
+	// on a big circuit. a font pixel is as wide as a screen pixel at the default zoom of
+	// 600 pixels high, so labels look as the raster text they replace did
+	coordLabels.clear();
+	EdgeSpan walls = track.walls();
+	if (walls.empty())
+		return;
+
+	float minX = walls[0].p1.x, maxX = minX, minY = walls[0].p1.y, maxY = minY;
+	for (size_t i = 0; i < walls.size(); i++) {
+		minX = std::min(minX, std::min(walls[i].p1.x, walls[i].p2.x));
+		maxX = std::max(maxX, std::max(walls[i].p1.x, walls[i].p2.x));
+		minY = std::min(minY, std::min(walls[i].p1.y, walls[i].p2.y));
+		maxY = std::max(maxY, std::max(walls[i].p1.y, walls[i].p2.y));
+	}
+
+	const int labelLimit = 16384;
+	const float pixel = 2 * 10.0f * tan(30 * piOver180) / 600;
+	int firstX = (int)floor(minX), lastX = (int)ceil(maxX), firstY = (int)floor(minY), lastY = (int)ceil(maxY);
+	int step = 1;
+	while ((long long)((lastX - firstX) / step + 1) * ((lastY - firstY) / step + 1) > labelLimit)
+		step *= 2;
+
+	// blocks start on whole multiples of their size, so each lines up with a chunk
+	const int blockLabels = 8;	// along each side
+	const int blockSize = blockLabels * step;
+	labelChunks.clear((float)blockSize);
+	firstX = labelChunks.column((float)firstX) * blockSize;
+	firstY = labelChunks.row((float)firstY) * blockSize;
+	char label[32];
+	for (int blockY = firstY; blockY <= lastY; blockY += blockSize) {
+		for (int blockX = firstX; blockX <= lastX; blockX += blockSize) {
+			GLint first = (GLint)coordLabels.size() * 4;
+			for (int y = blockY; y < blockY + blockSize && y <= lastY; y += step) {
+				for (int x = blockX; x < blockX + blockSize && x <= lastX; x += step) {
+					snprintf(label, sizeof(label), "(%d,%d)", x, y);
+					labelFont.layout(coordLabels, label, (float)x, (float)y, pixel);
+				}
+			}
+
+			// labels hang off to the right of and above their point, by up to a unit
+			Bounds bounds = { (float)blockX, (float)blockY, (float)(blockX + blockSize) + 1, (float)(blockY + blockSize) + 1 };
+			labelChunks.add(blockX / blockSize, blockY / blockSize, bounds, first, (GLsizei)coordLabels.size() * 4 - first);
+		}
+	}
+}
+
+void renderTrack(void) {
+	trackChunks.visible(viewBounds(), visibleFirsts, visibleCounts);
+	trackLines.draw(visibleFirsts, visibleCounts);
+}
+
+void renderWaypoints(void) {
+	waypointChunks.visible(viewBounds(), visibleFirsts, visibleCounts);
+	waypointLines.draw(visibleFirsts, visibleCounts);
+}
+
+void camera(void) {
+	glTranslatef(-cam_x, -cam_y, 0.0f);
+}
+
+// what the hud was last laid out for, times in hundredths of a second
+long shownLapTime = -1;
+long shownBestLap = -1;
+long shownSplit = -1;
+int shownPosition = -1;
+int shownLaps = -1;
+
+void renderTimer(void) {
+	// the text is only laid out again when a number on it changes at the 2dp it shows
+	if (!scene)
+		return;
+	float lapTime = scene->lapTime, bestLap = scene->bestLap;
+	long lapHundredths = lround(lapTime * 100), bestHundredths = lround(bestLap * 100), splitHundredths = lround(scene->lastSplit * 100);
+	if (lapHundredths != shownLapTime || bestHundredths != shownBestLap || splitHundredths != shownSplit ||
+		scene->position != shownPosition || scene->lapsDone != shownLaps) {
+		shownLapTime = lapHundredths;
+		shownBestLap = bestHundredths;
+		shownSplit = splitHundredths;
+		shownPosition = scene->position;
+		shownLaps = scene->lapsDone;
+
+		char line[64];
+		hudText.clear();
+		snprintf(line, sizeof(line), "Lap time  : %.2f", lapTime);
+		hudFont.layout(hudText, line, 20, 20, 1, true);
+		snprintf(line, sizeof(line), "Best lap time : %.2f", bestLap);
+		hudFont.layout(hudText, line, 20, 50, 1, true);
+		snprintf(line, sizeof(line), "Last sector : %.2f", scene->lastSplit);
+		hudFont.layout(hudText, line, 20, 80, 1, true);
+		snprintf(line, sizeof(line), "Position : %d / %d   Laps : %d", scene->position + 1, (int)scene->size(), scene->lapsDone);
+		hudFont.layout(hudText, line, 20, 110, 1, true);
+	}
+
+	// set to projection mode to draw as a HUD
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();		// save matrix
+		glLoadIdentity(); // reset matrix
+		glOrtho(0, 800, 600, 0, 0, -1); // ortho transform to width/height of screen
+		glMatrixMode(GL_MODELVIEW);  // set back to modelview
+		glPushMatrix(); 
+			glLoadIdentity();
+
+			// timers and race position, one draw
+			hudText.draw(hudFont.texture());
+
+			glMatrixMode(GL_PROJECTION);
+		glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+}
+
+#ifdef RACEGAME_PROFILE
+bool profileOverlay = true;
+
+// recent percentiles of every scope, down the right of the screen
+void renderProfile(void) {
+	static std::vector<ProfileStat> stats;
+	static SpriteBatch profileText;
+	profileStats(stats);
+
+	char line[96];
+	profileText.clear();
+	labelFont.layout(profileText, "scope             p50     p95     p99 us", 520, 20, 1, true);
+	for (size_t i = 0; i < stats.size(); i++) {
+		snprintf(line, sizeof(line), "%-14s %7.1f %7.1f %7.1f", stats[i].name, stats[i].p50, stats[i].p95, stats[i].p99);
+		labelFont.layout(profileText, line, 520, 34 + 12 * (float)i, 1, true);
+	}
+
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+		glLoadIdentity();
+		glOrtho(0, 800, 600, 0, 0, -1);
+		glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+			glLoadIdentity();
+			profileText.draw(labelFont.texture());
+			glMatrixMode(GL_PROJECTION);
+		glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+}
+#endif
+
+// the labels in view in one draw - they were formatted and rasterised one by one every
+// frame, which was far too slow to leave on
+void drawCoords(void) {
+	labelChunks.visible(viewBounds(), visibleFirsts, visibleCounts);
+	coordLabels.draw(labelFont.texture(), visibleFirsts, visibleCounts);
+}
+
+// sets the viewport and perspective for a window of the given size
+void setProjection(int width, int height) {
+
+	// set viewport to size of window
+	glViewport(0, 0, (GLsizei)width, (GLsizei)height);
+	viewAspect = (float)width / height;
+
+	// switch to projection matrix
+	glMatrixMode(GL_PROJECTION);
+
+	// reset the projection matrix to the identity matrix (cleaning up)
+	glLoadIdentity();
+
+	// set up view: fov, aspect ratio, near + far plane
+	gluPerspective(60, (GLfloat)width / (GLfloat)height, 1.0, 100.0);
+
+	// set back to model view matrix
+	glMatrixMode(GL_MODELVIEW);
+}
+
+// clears the frame and moves to the camera - everything after this draws in world space
+void beginFrame(void) {
+	// clear background to a colour
+	glClearColor(0.0f, 0.5f, 0.5f, 1.0f);
+
+	// clear the colour buffer
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	// load the identity matrix to reset drawing locations
+	glLoadIdentity();
+
+	camera();
+
+	// push back everything 5 units on the z axis, so we can see it
+	glTranslatef(0.0f, 0.0f, -10.0f);
+
+	drawCalls = 0;
+}
+
+void renderScene(void) {
+	beginFrame();
+	{
+		PROFILE_SCOPE("background");
+		renderBackground();
+	}
+	{
+		PROFILE_SCOPE("draw cars");
+		renderCars();
+	}
+	{
+		PROFILE_SCOPE("draw track");
+		renderTrack();
+	}
+	{
+		PROFILE_SCOPE("hud");
+		renderTimer();
+	}
+	if (debugMode) {
+		PROFILE_SCOPE("waypoints");
+		renderWaypoints();
+		drawCoords();		// useful for plotting track or waypoints - move the player car to see your way round
+	}
+#ifdef RACEGAME_PROFILE
+	if (profileOverlay)
+		renderProfile();
+#endif
+}
+
+int texturesCached() {
+	return textureCache.cachedCount();
+}
+
+int texturesDecoded() {
+	return textureCache.decodedCount();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// drawing the game world - only needs a current GL context, so the same code draws
+// into the GLUT window and into the offscreen benchmark (see renderbench.h)
+
+// global variables
+extern bool debugMode;	// draws bounding boxes, waypoints and ai lines
+
+#include "geometry.h"
+#include "simthread.h"
+
+// camera positions, the centre of the view in world units
+extern float cam_x;
+extern float cam_y;
+
+// how far to draw the cars from where they were at the start of the last tick towards
+// where they are now - the window sets this from the time left over after its last tick,
+// 1 (the default) draws them where they are
+extern float interpolation;
+
+// the race state everything is drawn from - a snapshot rather than the race, so the
+// simulation can run on while a frame is drawn. it has to stay put until the frame is done
+void setScene(const RaceSnapshot &snapshot);
+
+// where a car is drawn, going by interpolation
+point interpolatedPosition(int car);
+
+// starts loading the grass texture and car atlas from the texture cache, decoding any
+// that aren't baked on worker threads - returns false if any image is missing
+int loadTextures();
+
+// writes textures that had to be decoded back to the cache, so the next start maps them
+void saveTextureCache();
+
+// --bake-textures: decodes every texture and writes the cache, with no GL - returns the
+// process exit code
+int bakeTextures();
+
+// textures served from the cache and decoded by the last loadTextures()
+int texturesCached();
+int texturesDecoded();
+
+// fills the batches that never change, the track lines, waypoint markers and coordinate
+// labels - call again if the track or waypoints do
+void buildTrackLayer(void);
+
+// sets the viewport and perspective for a window of the given size
+void setProjection(int width, int height);
+
+// clears the frame and moves to the camera, resetting drawCalls
+void beginFrame(void);
+
+// the layers of a frame, in the order renderScene() draws them
+void renderBackground(void);
+void renderCars(void);
+void renderTrack(void);
+void renderTimer(void);
+void renderWaypoints(void);
+void drawCoords(void);		// a label at every whole unit over the track, baked by buildTrackLayer()
+
+// draws a whole frame at the current camera, without swapping buffers
+void renderScene(void);
+
+#ifdef RACEGAME_PROFILE
+// whether renderScene() draws the profile overlay, toggled with p
+extern bool profileOverlay;
+
+// the scopes' recent percentiles as text over the frame
+void renderProfile(void);
+#endif
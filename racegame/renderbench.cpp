@@ -0,0 +1,221 @@
+#include "renderbench.h"
+#include "graphics.h"
+#include "render.h"
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// the offscreen context comes from EGL, which only linux builds link against
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define RACEGAME_EGL
+#endif
+
+// same size as the window
+static const int frameWidth = 800;
+static const int frameHeight = 600;
+
+// the scene the race is drawn in - sim ticks run between frames, outside the timing
+static const int ticksPerFrame = 4;
+static const int warmupFrames = 10;
+
+#ifdef RACEGAME_EGL
+
+// makes a legacy (compatibility) GL context current, drawing into a pbuffer, or into a
+// framebuffer object if the driver can't give a pbuffer - mesa's surfaceless platform
+// needs no display server, and falls back to whatever EGL_DEFAULT_DISPLAY is
+static bool createOffscreenContext(int width, int height) {
+	EGLDisplay display = EGL_NO_DISPLAY;
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay)
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+		std::cout << "render bench: no EGL display" << std::endl;
+		return false;
+	}
+
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		std::cout << "render bench: EGL has no desktop OpenGL" << std::endl;
+		return false;
+	}
+
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configs = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &configs) || configs == 0) {
+		// surfaceless displays may have no pbuffer configs at all
+		const EGLint anyAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+		if (!eglChooseConfig(display, anyAttributes, &config, 1, &configs) || configs == 0) {
+			std::cout << "render bench: no EGL config for OpenGL" << std::endl;
+			return false;
+		}
+	}
+
+	// no attributes asks for the default, which is a compatibility profile
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+	if (context == EGL_NO_CONTEXT) {
+		std::cout << "render bench: couldn't create a GL context" << std::endl;
+		return false;
+	}
+
+	const EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	if (surface != EGL_NO_SURFACE)
+		return eglMakeCurrent(display, surface, surface, context) == EGL_TRUE;
+
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+		std::cout << "render bench: no pbuffer and no surfaceless context" << std::endl;
+		return false;
+	}
+
+	GLuint framebuffer, colour;
+	glGenRenderbuffers(1, &colour);
+	glBindRenderbuffer(GL_RENDERBUFFER, colour);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colour);
+	return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+#endif
+
+// nearest rank percentile of already sorted samples
+static double percentile(const std::vector<double> &sorted, double p) {
+	size_t rank = (size_t)(p * sorted.size() + 0.999999);
+	return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+// times from one layer of the frame, in milliseconds
+struct LayerTimes {
+	const char *name;
+	std::vector<double> samples;
+};
+
+int runRenderBenchmark(int frames, int cpuCars, const std::string &trackPath) {
+#ifdef RACEGAME_EGL
+	if (!createOffscreenContext(frameWidth, frameHeight))
+		return 1;
+
+	std::cout << "renderer    : " << glGetString(GL_RENDERER) << std::endl;
+
+	// cold start runs from here to the end of the first frame, as it does in the game
+	auto coldStart = std::chrono::steady_clock::now();
+	double firstFrame = 0;
+
+	// textures are loaded from the working directory, same as the game
+	if (!loadTextures()) {
+		std::cout << "render bench: couldn't load textures, run from the directory holding textures/" << std::endl;
+		return 1;
+	}
+
+	if (!initTrack(trackPath))
+		return 1;
+	initCars(cpuCars);
+	buildTrackLayer();
+	setProjection(frameWidth, frameHeight);
+
+	// glFinish after each layer so its time is the work it queued, not just the calls
+	typedef void (*Layer)(void);
+	const Layer layers[] = { beginFrame, renderBackground, renderCars, renderTrack, renderTimer, renderWaypoints, drawCoords };
+	std::vector<LayerTimes> times = {
+		{ "clear" }, { "background" }, { "cars" }, { "track" }, { "timer" }, { "waypoints" }, { "coords" }, { "frame" }
+	};
+	const size_t layerCount = sizeof(layers) / sizeof(layers[0]);
+	int minDrawCalls = 0, maxDrawCalls = 0;
+
+	// drawn from a snapshot as the window is, but taken here on the one thread
+	RaceSnapshot scene;
+	setScene(scene);
+
+	for (int frame = -warmupFrames; frame < frames; frame++) {
+		// the script: the player holds the throttle, everyone else races, and the camera
+		// rides with the first cpu car so the view keeps moving round the track
+		for (int tick = 0; tick < ticksPerFrame; tick++) {
+			race.cars.controls[playerCar] |= CONTROL_ACCELERATE;
+			stepSimulation();
+		}
+		scene.capture(race, std::chrono::steady_clock::now());
+		if (race.cars.size() > (size_t)cpuCar1) {
+			cam_x = race.cars.pos_x[cpuCar1];
+			cam_y = race.cars.pos_y[cpuCar1];
+		}
+		else if (!track.startLines().empty()) {
+			// with --cars 0 there's no cpu car to follow, so the camera sits on the start line
+			const edge &start = track.startLines()[0];
+			cam_x = (start.p1.x + start.p2.x) * 0.5f;
+			cam_y = (start.p1.y + start.p2.y) * 0.5f;
+		}
+
+		double frameTime = 0;
+		for (size_t layer = 0; layer < layerCount; layer++) {
+			auto start = std::chrono::steady_clock::now();
+			layers[layer]();
+			glFinish();
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			if (frame >= 0)
+				times[layer].samples.push_back(elapsed.count());
+			frameTime += elapsed.count();
+		}
+
+		if (frame == -warmupFrames) {
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - coldStart;
+			firstFrame = elapsed.count();
+		}
+
+		if (frame < 0)
+			continue;
+
+		times[layerCount].samples.push_back(frameTime);
+		minDrawCalls = frame == 0 ? drawCalls : std::min(minDrawCalls, drawCalls);
+		maxDrawCalls = frame == 0 ? drawCalls : std::max(maxDrawCalls, drawCalls);
+	}
+
+	if (glGetError() != GL_NO_ERROR)
+		std::cout << "render bench: GL reported an error" << std::endl;
+
+	std::cout << "cars        : " << race.cars.size() << std::endl;
+	std::cout << "frames      : " << frames << " at " << frameWidth << "x" << frameHeight << std::endl;
+	std::cout << "draw calls  : " << minDrawCalls;
+	if (maxDrawCalls != minDrawCalls)
+		std::cout << " to " << maxDrawCalls;
+	std::cout << " per frame" << std::endl;
+	std::cout << "first frame : " << firstFrame << " ms, " << texturesCached() << " textures cached, "
+		<< texturesDecoded() << " decoded" << std::endl;
+
+	std::cout << std::endl << std::setw(12) << std::left << "ms" << std::right
+		<< std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < times.size(); i++) {
+		std::vector<double> &samples = times[i].samples;
+		std::sort(samples.begin(), samples.end());
+		std::cout << std::setw(12) << std::left << times[i].name << std::right
+			<< std::setw(10) << percentile(samples, 0.50)
+			<< std::setw(10) << percentile(samples, 0.95)
+			<< std::setw(10) << percentile(samples, 0.99) << std::endl;
+	}
+
+	return 0;
+#else
+	(void)frames;
+	(void)cpuCars;
+	(void)trackPath;
+	std::cout << "render bench: this build has no offscreen context, it needs EGL (linux)" << std::endl;
+	return 1;
+#endif
+}
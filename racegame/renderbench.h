@@ -0,0 +1,11 @@
+#pragma once
+
+// frame timing for the render path, with no window - see runRenderBenchmark
+
+#include <string>
+
+// creates an offscreen GL context (EGL, which mesa's llvmpipe provides without a gpu or
+// display), then draws a fixed scripted race for the given number of frames and prints
+// p50/p95/p99 times for the whole frame and each layer, plus draw calls per frame -
+// returns the process exit code
+int runRenderBenchmark(int frames, int cpuCars, const std::string &trackPath);
@@ -0,0 +1,391 @@
+#include "replay.h"
+#include "profile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// file layout: this header, then the track path, then each car's run byte count, then
+// each car's runs, then the recorded laps. values are in the machine's own byte order
+struct ReplayHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t trackHash;
+	uint32_t seed;
+	uint32_t carCount;
+	uint32_t humanPlayer;
+	float maxSpeed, accelRate, decelRate, rotRate;
+	uint64_t tickCount;
+	uint32_t lapCount;
+	uint32_t pathLength;
+};
+
+static const char replayMagic[4] = { 'R', 'G', 'R', 'P' };
+// 2 - laps are timed along the centreline, so the laps kept in older logs no longer match
+// 3 - the track hash takes in the waypoints, sector lines and steering too
+// 4 - the grid is laid back along the centreline, so older logs start their cars elsewhere
+static const uint32_t replayVersion = 4;
+
+// a run is one varint - its controls in the low four bits and its length less one above
+// them, seven bits to a byte with the top bit set on all but the last. runs under eight
+// ticks take a byte, runs under a thousand take two
+static void appendRun(std::vector<uint8_t> &out, uint8_t controls, uint32_t length) {
+	uint64_t value = (uint64_t)(length - 1) << 4 | (controls & 15);
+	while (value >= 0x80) {
+		out.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t)value);
+}
+
+void ControlLog::begin(const Race &race, const std::string &trackPath, unsigned raceSeed, bool human, uint64_t expectedTicks) {
+	size_t cars = race.cars.size();
+	track = trackPath;
+	trackHash = hashTrack(*race.track);
+	seed = raceSeed;
+	humanPlayer = human;
+	tuning = race.tuning;
+	tickCount = 0;
+	played = 0;
+	laps.clear();
+
+	// a run never takes more bytes than it has ticks, so a byte a tick is room for the
+	// worst case - a car whose controls change every tick
+	runs.assign(cars, std::vector<uint8_t>());
+	for (size_t i = 0; i < cars; i++)
+		runs[i].reserve((size_t)expectedTicks);
+	runControls.assign(cars, 0);
+	runLength.assign(cars, 0);
+}
+
+void ControlLog::record(const CarPool &cars) {
+	for (size_t i = 0; i < cars.size(); i++) {
+		uint8_t controls = cars.controls[i];
+		if (runLength[i] > 0 && (controls != runControls[i] || runLength[i] == 0xffffffff)) {
+			appendRun(runs[i], runControls[i], runLength[i]);
+			runLength[i] = 0;
+		}
+		runControls[i] = controls;
+		runLength[i]++;
+	}
+	tickCount++;
+}
+
+void ControlLog::end(const Race &race) {
+	for (size_t i = 0; i < runs.size(); i++) {
+		if (runLength[i] > 0)
+			appendRun(runs[i], runControls[i], runLength[i]);
+		runLength[i] = 0;
+	}
+	laps = race.lapLog;
+}
+
+size_t ControlLog::encodedBytes() const {
+	size_t bytes = 0;
+	for (size_t i = 0; i < runs.size(); i++)
+		bytes += runs[i].size();
+	return bytes;
+}
+
+bool ControlLog::save(const std::string &path, std::string &error) const {
+	ReplayHeader header = {};
+	memcpy(header.magic, replayMagic, sizeof(header.magic));
+	header.version = replayVersion;
+	header.trackHash = trackHash;
+	header.seed = seed;
+	header.carCount = (uint32_t)runs.size();
+	header.humanPlayer = humanPlayer;
+	header.maxSpeed = tuning.maxSpeed;
+	header.accelRate = tuning.accelRate;
+	header.decelRate = tuning.decelRate;
+	header.rotRate = tuning.rotRate;
+	header.tickCount = tickCount;
+	header.lapCount = (uint32_t)laps.size();
+	header.pathLength = (uint32_t)track.size();
+
+	FILE *out = fopen(path.c_str(), "wb");
+	if (!out) {
+		error = "can't write " + path;
+		return false;
+	}
+
+	bool written = fwrite(&header, sizeof(header), 1, out) == 1;
+	written = written && fwrite(track.data(), 1, track.size(), out) == track.size();
+	for (size_t i = 0; i < runs.size() && written; i++) {
+		uint32_t bytes = (uint32_t)runs[i].size();
+		written = fwrite(&bytes, sizeof(bytes), 1, out) == 1;
+	}
+	for (size_t i = 0; i < runs.size() && written; i++)
+		written = fwrite(runs[i].data(), 1, runs[i].size(), out) == runs[i].size();
+	if (written && !laps.empty())
+		written = fwrite(laps.data(), sizeof(LapRecord), laps.size(), out) == laps.size();
+
+	written = fclose(out) == 0 && written;
+	if (!written) {
+		remove(path.c_str());
+		error = "couldn't write all of " + path;
+	}
+	return written;
+}
+
+bool ControlLog::load(const std::string &path, std::string &error) {
+	FILE *in = fopen(path.c_str(), "rb");
+	if (!in) {
+		error = "can't open " + path;
+		return false;
+	}
+
+	// read into these, so a bad file leaves the loaded log alone
+	ReplayHeader header;
+	std::string trackName;
+	std::vector<std::vector<uint8_t>> carRuns;
+	std::vector<LapRecord> lapRecords;
+
+	bool valid = fread(&header, sizeof(header), 1, in) == 1 && memcmp(header.magic, replayMagic, sizeof(header.magic)) == 0;
+	if (valid && header.version != replayVersion) {
+		fclose(in);
+		error = path + " is from a different version of the game";
+		return false;
+	}
+
+	// the counts are checked against what's left of the file before anything is sized by them
+	long start = valid ? ftell(in) : 0;
+	fseek(in, 0, SEEK_END);
+	long remaining = ftell(in) - start;
+	fseek(in, start, SEEK_SET);
+	valid = valid && (uint64_t)header.pathLength + (uint64_t)header.carCount * sizeof(uint32_t) +
+		(uint64_t)header.lapCount * sizeof(LapRecord) <= (uint64_t)remaining;
+
+	if (valid) {
+		trackName.resize(header.pathLength);
+		valid = fread(&trackName[0], 1, trackName.size(), in) == trackName.size();
+	}
+
+	std::vector<uint32_t> runBytes(valid ? header.carCount : 0);
+	valid = valid && fread(runBytes.data(), sizeof(uint32_t), runBytes.size(), in) == runBytes.size();
+	carRuns.resize(runBytes.size());
+	for (size_t i = 0; i < carRuns.size() && valid; i++) {
+		remaining -= runBytes[i];
+		valid = remaining >= 0;
+		if (valid) {
+			carRuns[i].resize(runBytes[i]);
+			valid = fread(carRuns[i].data(), 1, carRuns[i].size(), in) == carRuns[i].size();
+		}
+	}
+
+	if (valid) {
+		lapRecords.resize(header.lapCount);
+		valid = fread(lapRecords.data(), sizeof(LapRecord), lapRecords.size(), in) == lapRecords.size();
+	}
+	fclose(in);
+
+	if (!valid) {
+		error = path + " isn't a complete control log";
+		return false;
+	}
+
+	track = trackName;
+	trackHash = header.trackHash;
+	seed = header.seed;
+	humanPlayer = header.humanPlayer != 0;
+	tuning.maxSpeed = header.maxSpeed;
+	tuning.accelRate = header.accelRate;
+	tuning.decelRate = header.decelRate;
+	tuning.rotRate = header.rotRate;
+	tickCount = header.tickCount;
+	laps.swap(lapRecords);
+	runs.swap(carRuns);
+	runControls.assign(runs.size(), 0);
+	runLength.assign(runs.size(), 0);
+	played = tickCount;
+	return true;
+}
+
+bool ControlLog::start(Race &race, const Track &raceTrack, std::string &error) {
+	if (hashTrack(raceTrack) != trackHash) {
+		error = track + " has changed since this log was recorded";
+		return false;
+	}
+
+	size_t humans = humanPlayer ? 1 : 0;
+	if (runs.size() < humans) {
+		error = "the log has no cars";
+		return false;
+	}
+	race.tuning = tuning;
+	if (initRace(race, raceTrack, (int)(runs.size() - humans), humanPlayer, seed, tickCount) != (int)runs.size()) {
+		error = "the log has more cars than fit on the grid of " + track;
+		return false;
+	}
+
+	cursor.assign(runs.size(), 0);
+	runLeft.assign(runs.size(), 0);
+	runControls.assign(runs.size(), 0);
+	played = 0;
+	return true;
+}
+
+bool ControlLog::play(CarPool &cars) {
+	if (played >= tickCount)
+		return false;
+
+	for (size_t i = 0; i < runs.size(); i++) {
+		if (runLeft[i] == 0) {
+			// a log that ends early for one car leaves it with no controls
+			const std::vector<uint8_t> &bytes = runs[i];
+			uint64_t value = 0;
+			int shift = 0;
+			while (cursor[i] < bytes.size() && shift < 64) {
+				uint8_t b = bytes[cursor[i]++];
+				value |= (uint64_t)(b & 0x7f) << shift;
+				shift += 7;
+				if (!(b & 0x80))
+					break;
+			}
+			runControls[i] = shift > 0 ? (uint8_t)(value & 15) : 0;
+			runLeft[i] = shift > 0 ? (uint32_t)(value >> 4) + 1 : 0xffffffff;
+		}
+		cars.controls[i] = runControls[i];
+		runLeft[i]--;
+	}
+
+	played++;
+	return true;
+}
+
+bool ControlLog::lapsMatch(const Race &race, std::string &difference) const {
+	const std::vector<LapRecord> &replayed = race.lapLog;
+	size_t common = std::min(laps.size(), replayed.size());
+	for (size_t i = 0; i < common; i++) {
+		// compared as bits, so even a difference in the last place shows up
+		if (laps[i].car != replayed[i].car || memcmp(&laps[i].seconds, &replayed[i].seconds, sizeof(float)) != 0) {
+			char text[160];
+			snprintf(text, sizeof(text), "lap %d was car %d in %.9g s, replayed as car %d in %.9g s", (int)i + 1,
+				laps[i].car, laps[i].seconds, replayed[i].car, replayed[i].seconds);
+			difference = text;
+			return false;
+		}
+	}
+
+	if (laps.size() != replayed.size()) {
+		difference = std::to_string(laps.size()) + " laps were recorded, but the replay finished " + std::to_string(replayed.size());
+		return false;
+	}
+	return true;
+}
+
+// the window's log, and where it goes
+static ControlLog windowLog;
+static std::string recordingPath;
+static bool replayChecked = false;
+
+static void saveAtExit() {
+	saveRecording();
+}
+
+void startRecording(const std::string &path, const std::string &trackPath, uint64_t expectedTicks) {
+	windowLog.begin(race, trackPath, 0, race.cars.size() > 0 && race.cars.playerControlled[playerCar], expectedTicks);
+	race.recording = &windowLog;
+	recordingPath = path;
+
+	// escape, and closing the window, both leave through exit()
+	static bool registered = false;
+	if (!registered) {
+		atexit(saveAtExit);
+		registered = true;
+	}
+}
+
+bool saveRecording() {
+	if (!race.recording)
+		return true;
+
+	race.recording = nullptr;
+	windowLog.end(race);
+	std::string error;
+	if (!windowLog.save(recordingPath, error)) {
+		std::cout << "couldn't save control log: " << error << std::endl;
+		return false;
+	}
+	std::cout << "recorded " << windowLog.ticks() << " ticks to " << recordingPath << " (" << windowLog.encodedBytes() << " bytes of controls)" << std::endl;
+	return true;
+}
+
+bool startReplay(const std::string &path) {
+	std::string error;
+	if (!windowLog.load(path, error)) {
+		std::cout << "couldn't load control log: " << error << std::endl;
+		return false;
+	}
+	if (!initTrack(windowLog.trackPath()))
+		return false;
+	if (!windowLog.start(race, track, error)) {
+		std::cout << "couldn't replay " << path << ": " << error << std::endl;
+		return false;
+	}
+	race.replaying = &windowLog;
+	replayChecked = false;
+	return true;
+}
+
+void checkReplay() {
+	if (!race.replaying || replayChecked || !windowLog.finished())
+		return;
+
+	replayChecked = true;
+	std::string difference;
+	if (windowLog.lapsMatch(race, difference))
+		std::cout << "replay finished, " << race.lapLog.size() << " laps match the recording" << std::endl;
+	else
+		std::cout << "replay finished, DIFFERENT from the recording: " << difference << std::endl;
+}
+
+int runReplay(const std::string &path) {
+	ControlLog log;
+	std::string error;
+	if (!log.load(path, error)) {
+		std::cout << "couldn't load control log: " << error << std::endl;
+		return 1;
+	}
+
+	Track replayTrack;
+	if (!replayTrack.load(log.trackPath(), error)) {
+		std::cout << "couldn't load track: " << error << std::endl;
+		return 1;
+	}
+
+	Race replayRace;
+	if (!log.start(replayRace, replayTrack, error)) {
+		std::cout << "couldn't replay " << path << ": " << error << std::endl;
+		return 1;
+	}
+	replayRace.replaying = &log;
+
+	auto start = std::chrono::steady_clock::now();
+	while (!log.finished()) {
+		stepRace(replayRace);
+
+#ifdef RACEGAME_PROFILE
+		if ((replayRace.ticks & 255) == 0)
+			profileCollect();
+#endif
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << "cars        : " << replayRace.cars.size() << std::endl;
+	std::cout << "ticks       : " << log.ticks() << std::endl;
+	std::cout << "log bytes   : " << log.encodedBytes() << std::endl;
+	std::cout << "wall seconds: " << elapsed.count() << std::endl;
+	std::cout << "ticks/sec   : " << (elapsed.count() > 0 ? log.ticks() / elapsed.count() : 0) << std::endl;
+	std::cout << "laps        : " << replayRace.lapLog.size() << std::endl;
+
+	std::string difference;
+	if (!log.lapsMatch(replayRace, difference)) {
+		std::cout << "FAILED: " << difference << std::endl;
+		return 1;
+	}
+	std::cout << "lap times match the recording bit for bit" << std::endl;
+	return 0;
+}
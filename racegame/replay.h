@@ -0,0 +1,86 @@
+#pragma once
+
+// control logs - every car's controls for every tick of a race, so the race can be run
+// again exactly. the simulation is deterministic given the track, the starting grid and
+// the controls, so nothing else needs storing. each car's controls are kept as runs of
+// identical ticks, a few bits each, since they change far less often than every tick
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+class ControlLog {
+public:
+	// starts logging a race that initRace has just set up, from the given track file. room
+	// is kept for expectedTicks ticks up front, so recording that many never allocates
+	void begin(const Race &race, const std::string &trackPath, unsigned seed, bool humanPlayer, uint64_t expectedTicks = 4096);
+
+	// adds this tick's controls for every car - called by stepRace once they are all set
+	void record(const CarPool &cars);
+
+	// closes the last run of every car and keeps the laps the race finished, to check a
+	// replay against
+	void end(const Race &race);
+
+	bool save(const std::string &path, std::string &error) const;
+	bool load(const std::string &path, std::string &error);
+
+	// sets up a race to replay this log from the first tick, on a track loaded from
+	// trackPath() - returns false, saying why, if it's a different track to the one recorded
+	bool start(Race &race, const Track &track, std::string &error);
+
+	// sets every car's controls for the next tick - returns false once the log has run out
+	bool play(CarPool &cars);
+
+	// whether a replayed race finished the same laps as the recorded one, to the bit - on a
+	// mismatch difference describes the first lap that differs
+	bool lapsMatch(const Race &race, std::string &difference) const;
+
+	const std::string &trackPath() const { return track; }
+	uint64_t ticks() const { return tickCount; }
+	bool finished() const { return played >= tickCount; }
+
+	// bytes the runs take up, over every car
+	size_t encodedBytes() const;
+
+private:
+	std::string track;
+	uint32_t trackHash = 0;
+	uint32_t seed = 0;
+	bool humanPlayer = false;
+	CarTuning tuning;
+	uint64_t tickCount = 0;
+	std::vector<LapRecord> laps;
+
+	// each car's runs, one after another - see appendRun
+	std::vector<std::vector<uint8_t>> runs;
+
+	// while recording, the run each car is in the middle of
+	std::vector<uint8_t> runControls;
+	std::vector<uint32_t> runLength;
+
+	// while replaying, how far through each car's runs it is
+	std::vector<size_t> cursor;
+	std::vector<uint32_t> runLeft;
+	uint64_t played = 0;
+};
+
+// --record: logs the window's race from its first tick, written to path when the program
+// exits - a run that knows how long it is says so, and records without allocating
+void startRecording(const std::string &path, const std::string &trackPath, uint64_t expectedTicks = 4096);
+
+// writes the window's log now, rather than at exit - returns false (printing why) if it can't
+bool saveRecording();
+
+// --replay: loads the log's track and sets the window's race up to follow the log
+bool startReplay(const std::string &path);
+
+// called by the window each tick - once the replay has run out, says once whether the
+// laps came out the same
+void checkReplay();
+
+// --replay with --fast: runs a log through as fast as possible with no window, then
+// prints the throughput and checks the laps - returns the process exit code, non-zero if
+// anything differs
+int runReplay(const std::string &path);
@@ -0,0 +1,27 @@
+#pragma once
+
+// which simd instruction sets the kernels can be built with. sse2 is part of every x86-64
+// cpu, so it's used whenever the compiler targets it; avx has to be checked for when the
+// program runs (see collisionKernel()), and only functions marked RACEGAME_TARGET_AVX use it
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define RACEGAME_X86
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RACEGAME_SSE2
+#endif
+
+// gcc and clang only emit avx instructions in functions marked for it, msvc always can
+#if defined(RACEGAME_X86) && defined(RACEGAME_SSE2)
+#define RACEGAME_AVX
+#if defined(__GNUC__) || defined(__clang__)
+#define RACEGAME_TARGET_AVX __attribute__((target("avx")))
+#else
+#define RACEGAME_TARGET_AVX
+#endif
+#endif
@@ -0,0 +1,86 @@
+#include "simthread.h"
+#include "frameclock.h"
+#include "replay.h"
+#include "profile.h"
+
+// copies one array into another the same length, keeping the destination's storage
+template <typename T> static void copyInto(std::vector<T> &to, const std::vector<T> &from) {
+	to.assign(from.begin(), from.end());
+}
+
+void RaceSnapshot::capture(const Race &race, std::chrono::steady_clock::time_point stateTime) {
+	const CarPool &cars = race.cars;
+	tick = race.ticks;
+	time = stateTime;
+
+	copyInto(prev_x, cars.prev_x);
+	copyInto(prev_y, cars.prev_y);
+	copyInto(prev_vel_x, cars.prev_vel_x);
+	copyInto(prev_vel_y, cars.prev_vel_y);
+	copyInto(pos_x, cars.pos_x);
+	copyInto(pos_y, cars.pos_y);
+	copyInto(vel_x, cars.vel_x);
+	copyInto(vel_y, cars.vel_y);
+	copyInto(playerControlled, cars.playerControlled);
+	copyInto(nextWaypoint, cars.nextWaypoint);
+
+	const LapTimers &laps = race.laps;
+	bool timed = !laps.current.empty();
+	lapTime = timed ? laps.current[playerCar] : 0.0f;
+	bestLap = timed ? laps.best[playerCar] : 0.0f;
+	lastSplit = timed ? laps.lastSplit[playerCar] : 0.0f;
+	position = timed ? laps.position[playerCar] : 0;
+	lapsDone = timed ? laps.completed[playerCar] : 0;
+
+	ghostVisible = race.ghost && race.ghost->visible();
+	if (ghostVisible) {
+		ghost = race.ghost->pose();
+		previousGhost = race.ghost->previousPose();
+	}
+}
+
+void SimulationThread::start() {
+	stop();
+
+	// there's a snapshot to draw before the first tick
+	snapshots.back().capture(race, std::chrono::steady_clock::now());
+	snapshots.publish();
+
+	running.store(true);
+	thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+	running.store(false);
+	if (thread.joinable())
+		thread.join();
+}
+
+// ticks as real time reaches them and publishes after each batch, sleeping in between -
+// the same fixed steps and catch-up limit as the window used to run itself
+void SimulationThread::run() {
+	FrameClock clock(tickSeconds);
+	clock.start();
+
+	while (running.load(std::memory_order_relaxed)) {
+		int ticks = clock.ticksDue();
+		for (int i = 0; i < ticks; i++) {
+			PROFILE_SCOPE("tick");
+
+			// held keys apply to every tick, as when the window read them each tick itself
+			if (race.cars.size() > playerCar && race.cars.playerControlled[playerCar])
+				race.cars.controls[playerCar] |= playerControls.load(std::memory_order_relaxed);
+
+			stepSimulation();
+			checkReplay();
+		}
+
+		if (ticks > 0) {
+			PROFILE_SCOPE("publish");
+			snapshots.back().capture(race, clock.reached());
+			snapshots.publish();
+		}
+
+		clock.waitForTick();
+	}
+}
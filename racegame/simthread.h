@@ -0,0 +1,71 @@
+#pragma once
+
+// the window's race on a thread of its own - it ticks at the fixed rate in real time and
+// publishes a copy of what the renderer needs after every tick, so a slow frame doesn't
+// hold up physics and a slow tick doesn't hold up drawing. nothing is shared with the
+// render thread but the snapshots and the player's controls
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "simulation.h"
+#include "triplebuffer.h"
+#include "ghost.h"
+
+// what the renderer needs of a race at one tick, copied out so the simulation can carry on
+struct RaceSnapshot {
+	long tick = 0;
+	std::chrono::steady_clock::time_point time;		// the real time this tick's state belongs to
+
+	// each car at the start of the tick and at its end, to draw between
+	std::vector<float> prev_x, prev_y, prev_vel_x, prev_vel_y;
+	std::vector<float> pos_x, pos_y, vel_x, vel_y;
+	std::vector<unsigned char> playerControlled;
+	std::vector<int> nextWaypoint;
+
+	// the player's, or the first car's without one
+	float lapTime = 0.0f, bestLap = 0.0f;
+	float lastSplit = 0.0f;		// the last sector finished, 0 before the first
+	int position = 0;			// place in the race, 0 for the leader
+	int lapsDone = 0;
+
+	// the best lap's ghost, this tick and last, when it's out on the track
+	bool ghostVisible = false;
+	GhostPose ghost = {}, previousGhost = {};
+
+	size_t size() const { return pos_x.size(); }
+
+	// copies a race in - the arrays are reused, so once they're big enough it doesn't allocate
+	void capture(const Race &race, std::chrono::steady_clock::time_point stateTime);
+};
+
+class SimulationThread {
+public:
+	SimulationThread() {}
+	~SimulationThread() { stop(); }
+
+	SimulationThread(const SimulationThread &) = delete;
+	SimulationThread &operator=(const SimulationThread &) = delete;
+
+	// starts ticking the window's race, which belongs to this thread from now until stop()
+	void start();
+
+	// lets the tick under way finish, then waits for the thread to end
+	void stop();
+
+	// the player's control bits, applied to every tick until they are set again
+	void setPlayerControls(unsigned char controls) { playerControls.store(controls, std::memory_order_relaxed); }
+
+	// the newest tick published - call from the render thread only, the snapshot stays
+	// untouched until the next call
+	const RaceSnapshot &latest() { return snapshots.front(); }
+
+private:
+	std::thread thread;
+	std::atomic<bool> running{ false };
+	std::atomic<unsigned char> playerControls{ 0 };
+	TripleBuffer<RaceSnapshot> snapshots;
+
+	void run();
+};
@@ -0,0 +1,535 @@
+#include "simulation.h"
+#include "alloccount.h"
+#include "replay.h"
+#include "ghost.h"
+#include "profile.h"
+#include "raycast.h"
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+#include <chrono>
+
+// global variables
+float carLength = 1.0f;
+float carWidth = 0.5f;
+
+// pre-compute divisions
+float carLengthHalf = carLength / 2;
+float carWidthHalf = carWidth / 2;
+float piOver180 = 3.14159265359f / 180;
+
+void LapTimers::reset(size_t cars, size_t sectors) {
+	current.assign(cars, 0.0f);
+	best.assign(cars, 0.0f);
+	completed.assign(cars, 0);
+	started.assign(cars, 0);
+	segment.assign(cars, 0);
+	distance.assign(cars, 0.0f);
+
+	sectorCount = sectors;
+	sector.assign(cars, 0);
+	sectorStart.assign(cars, 0.0f);
+	lastSplit.assign(cars, 0.0f);
+	bestSplits.assign(cars * sectors, 0.0f);
+
+	order.resize(cars);
+	position.resize(cars);
+	for (size_t i = 0; i < cars; i++)
+		order[i] = position[i] = (int)i;
+}
+
+// the starting grid - the front row sits this far short of the start line and the rows
+// behind it this far apart, four abreast across a road this wide. the last row stays
+// this far behind the front one, going round the lap
+static const float gridFront = 0.6f;
+static const float gridRowSpacing = 1.5f;
+static const float gridWidth = 12.0f;
+static const float gridClearance = 10.0f;
+
+// how far either side of the centreline to look for the walls, finding a row's road
+static const float gridRoadRange = 30.0f;
+
+// small xorshift generator for the grid nudges - the same seed always gives the same grid
+static float nudge(unsigned &state, float range) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return ((state & 0xffff) / 65535.0f * 2 - 1) * range;
+}
+
+// where a grid slot goes and the way it faces - across the road from its middle, positive
+// to the right, and back from the start line. the front row squares up to the line; rows
+// further back follow the centreline, so a long grid goes round the road's corners, and
+// sit across the middle of the road there, which the centreline needn't run down
+static point gridSlot(const Track &track, float across, float back, float &dir_x, float &dir_y) {
+	const Centreline &centreline = track.centreline();
+	const edge &line = track.startLines()[0];
+	float line_x = line.p2.x - line.p1.x, line_y = line.p2.y - line.p1.y;
+	float length = sqrt(line_x * line_x + line_y * line_y);
+	dir_x = -line_y / length;
+	dir_y = line_x / length;
+	point p = { (line.p1.x + line.p2.x) * 0.5f, (line.p1.y + line.p2.y) * 0.5f };
+
+	if (!centreline.empty()) {
+		float road_x, road_y;
+		point on = centreline.pointAt(-back, road_x, road_y);
+		if (dir_x * road_x + dir_y * road_y < 0) {
+			dir_x = -dir_x;
+			dir_y = -dir_y;
+		}
+
+		if (back > gridFront) {
+			dir_x = road_x;
+			dir_y = road_y;
+			float left = castRay(track.grid(), on.x, on.y, -dir_y, dir_x, gridRoadRange);
+			float right = castRay(track.grid(), on.x, on.y, dir_y, -dir_x, gridRoadRange);
+			p.x = on.x + dir_y * (right - left) * 0.5f;
+			p.y = on.y - dir_x * (right - left) * 0.5f;
+
+			// a road narrower than the grid squeezes the slots together
+			across *= std::min(1.0f, (left + right) / gridWidth);
+			return { p.x + dir_y * across, p.y - dir_x * across };
+		}
+	}
+
+	// straight back from the line's middle
+	return { p.x - dir_x * back + dir_y * across, p.y - dir_y * back - dir_x * across };
+}
+
+int initRace(Race &race, const Track &raceTrack, int cpuCars, bool humanPlayer, unsigned seed, uint64_t expectedTicks) {
+	race.track = &raceTrack;
+	race.cars.clear();
+	race.lapLog.clear();
+	race.ticks = 0;
+
+	// the first two slots are side by side just short of the line, any further cars line
+	// up four abreast behind it. a row on the inside of a corner closes up on the ones
+	// ahead, so it drops back until it's clear of the last few, and a grid that would
+	// reach round the lap to its own front is cut short
+	const float frontRow[] = { 0.0f, 2.0f }, row[] = { -4.5f, -1.5f, 1.5f, 4.5f };
+	int carCount = cpuCars + (humanPlayer ? 1 : 0);
+	const Centreline &centreline = raceTrack.centreline();
+	unsigned state = seed;
+	float back = gridFront;
+	CarEdges ahead[16];
+	int aheadCount = 0, nextAhead = 0;
+	for (int slot = 0; slot < carCount;) {
+		const float *across = slot == 0 ? frontRow : row;
+		int count = std::min(slot == 0 ? 2 : 4, carCount - slot);
+		point places[4];
+		float dir_x[4], dir_y[4];
+		CarEdges boxes[4];
+		bool clear = false;
+		while (!clear) {
+			if (!centreline.empty() && back > centreline.length() - gridClearance)
+				break;
+
+			clear = true;
+			for (int i = 0; i < count; i++) {
+				places[i] = gridSlot(raceTrack, across[i], back, dir_x[i], dir_y[i]);
+				carEdgesAt(places[i].x, places[i].y, dir_x[i], dir_y[i], boxes[i]);
+				for (int j = 0; j < aheadCount; j++)
+					clear = clear && !isColliding(boxes[i], ahead[j]);
+			}
+			if (!clear)
+				back += gridRowSpacing * 0.25f;
+		}
+		if (!clear)
+			break;
+
+		for (int i = 0; i < count; i++) {
+			float heading = atan2(-dir_x[i], dir_y[i]) / piOver180;
+			float x = places[i].x, y = places[i].y;
+			if (seed != 0) {
+				x += nudge(state, 0.3f);
+				y += nudge(state, 0.3f);
+				heading += nudge(state, 3.0f);
+			}
+
+			int car = race.cars.add(x, y, humanPlayer && slot + i == 0);
+			race.cars.rot[car] = race.cars.prev_rot[car] = heading;
+			race.cars.vel_x[car] = race.cars.prev_vel_x[car] = -sin(heading * piOver180);
+			race.cars.vel_y[car] = race.cars.prev_vel_y[car] = cos(heading * piOver180);
+			ahead[nextAhead] = boxes[i];
+			nextAhead = (nextAhead + 1) % 16;
+		}
+		aheadCount = std::min(aheadCount + count, 16);
+		slot += count;
+		back += gridRowSpacing;
+	}
+
+	// every car starts somewhere short of the line, even one put down past it - a lap
+	// only begins once a car reaches the line
+	LapTimers &laps = race.laps;
+	laps.reset(race.cars.size(), centreline.sectorDistances().size() + 1);
+	for (size_t i = 0; i < race.cars.size(); i++) {
+		laps.segment[i] = centreline.nearestSegment(race.cars.pos_x[i], race.cars.pos_y[i]);
+		laps.distance[i] = centreline.project(race.cars.pos_x[i], race.cars.pos_y[i], laps.segment[i]) - centreline.length();
+	}
+	if (race.ghost)
+		race.ghost->restart();
+
+	// no car goes further than top speed plus one tick's acceleration each tick, so that
+	// bounds the laps each can finish in expectedTicks - one more covers reaching the line
+	// from the grid, so logging a lap doesn't allocate mid-race
+	if (centreline.length() > 0) {
+		double reach = (double)expectedTicks * (race.tuning.maxSpeed + race.tuning.accelRate);
+		race.lapLog.reserve(race.cars.size() * ((size_t)(reach / centreline.length()) + 2));
+	}
+	return (int)race.cars.size();
+}
+
+// does circle/circle collision detection to determine whether it has hit waypoint
+// this only tracks progress now, for the debug view
+void checkWaypointHit(Race &race, int car) {
+	CarPool &cars = race.cars;
+	ArrayView<point> waypoints = race.track->waypoints();
+	int &nextWaypoint = cars.nextWaypoint[car];
+	float dist_x = cars.pos_x[car] - waypoints[nextWaypoint].x;
+	float dist_y = cars.pos_y[car] - waypoints[nextWaypoint].y;
+
+	// compared squared, within 3 units - cpu cars take their own line now, so they pass
+	// waypoints wider than they used to
+	if (dist_x * dist_x + dist_y * dist_y <= 3.0f * 3.0f) {
+		if (nextWaypoint == (int)waypoints.size() - 1) { // check if final waypoint reached
+			nextWaypoint = 0;						// reset back to first waypoint
+		}
+		else
+			nextWaypoint++;
+	}
+}
+
+// a sector finished - its split, and the car's best for it
+static void splitSector(LapTimers &laps, int car) {
+	float split = laps.current[car] - laps.sectorStart[car];
+	float &best = laps.bestSplits[car * laps.sectorCount + laps.sector[car]];
+	if (best == 0.0f || split < best)
+		best = split;
+	laps.lastSplit[car] = split;
+	laps.sectorStart[car] = laps.current[car];
+	laps.sector[car]++;
+}
+
+// lap timer - each car is moved along the centreline by however far it went this tick,
+// taken the short way round, so backing over the line and driving over it again doesn't
+// count. a lap ends each time a car gets a whole lap further on than the last one began
+void doLapTimer(Race &race) {
+	CarPool &cars = race.cars;
+	LapTimers &laps = race.laps;
+	const Centreline &centreline = race.track->centreline();
+	const std::vector<float> &sectorLines = centreline.sectorDistances();
+	const float length = centreline.length();
+
+	for (size_t i = 0; i < cars.size(); i++) {
+		int car = (int)i;
+
+		// the clock only runs once a car has reached the line
+		if (laps.started[i])
+			laps.current[i] += tickSeconds;
+
+		float &distance = laps.distance[i];
+		float was = distance < 0 ? distance + length : distance;
+		float moved = centreline.project(cars.pos_x[i], cars.pos_y[i], laps.segment[i]) - was;
+		if (moved > length * 0.5f)
+			moved -= length;
+		else if (moved < -length * 0.5f)
+			moved += length;
+		distance += moved;
+
+		if (!laps.started[i]) {
+			// reversing away from the line before reaching it
+			if (distance < -length)
+				distance += length;
+			if (distance >= 0)
+				laps.started[i] = true;
+			continue;
+		}
+
+		while (laps.sector[i] < (int)sectorLines.size() && distance >= sectorLines[laps.sector[i]])
+			splitSector(laps, car);
+
+		// car over the finish line after a lap
+		if (distance >= length) {
+			splitSector(laps, car);
+			laps.sector[i] = 0;
+			laps.sectorStart[i] = 0.0f;
+			distance -= length;
+
+			// first lap, or a new best
+			if (laps.completed[i] == 0 || laps.current[i] < laps.best[i])
+				laps.best[i] = laps.current[i];
+
+			laps.completed[i]++;
+			race.lapLog.push_back({ car, laps.current[i] });
+
+			// reset lap timer
+			laps.current[i] = 0.0f;
+		}
+	}
+
+	// race order by laps then distance round - an insertion sort, since between one tick
+	// and the next only the odd pair of cars swaps
+	auto ahead = [&](int a, int b) {
+		if (laps.completed[a] != laps.completed[b])
+			return laps.completed[a] > laps.completed[b];
+		return laps.distance[a] > laps.distance[b];
+	};
+	std::vector<int> &order = laps.order;
+	for (size_t i = 1; i < order.size(); i++) {
+		int car = order[i];
+		size_t j = i;
+		for (; j > 0 && ahead(car, order[j - 1]); j--)
+			order[j] = order[j - 1];
+		order[j] = car;
+	}
+	for (size_t i = 0; i < order.size(); i++)
+		laps.position[order[i]] = (int)i;
+}
+
+// puts a car back where it was before this tick's move, facing the way it was - turning
+// on the spot can hit things too
+static void undoMove(CarPool &cars, int car) {
+	cars.pos_x[car] = cars.prev_x[car];
+	cars.pos_y[car] = cars.prev_y[car];
+	cars.rot[car] = cars.prev_rot[car];
+	cars.vel_x[car] = cars.prev_vel_x[car];
+	cars.vel_y[car] = cars.prev_vel_y[car];
+
+	// set speed to 0 so next tick doesn't re-cause collision
+	cars.speed[car] = 0;
+}
+
+// a car that has run into a wall keeps the part of its move along the wall and loses
+// the part into it, and is turned to face along the wall - a glancing blow barely slows
+// it, a head on one stops it. if it still can't go there it is put back where it was
+static void slideAlongWall(CarPool &cars, const DistanceField &walls, const TrackGrid &edges, int car) {
+	point normal;
+	walls.nearestPoint(cars.edges(car), normal);
+
+	float move_x = cars.pos_x[car] - cars.prev_x[car];
+	float move_y = cars.pos_y[car] - cars.prev_y[car];
+	float before = sqrt(move_x * move_x + move_y * move_y);
+	float into = move_x * normal.x + move_y * normal.y;
+	if (into < 0) {
+		move_x -= into * normal.x;
+		move_y -= into * normal.y;
+	}
+	float after = sqrt(move_x * move_x + move_y * move_y);
+
+	// nearly head on, there's nothing to slide along
+	if (before <= 0 || after < before * 0.2f) {
+		undoMove(cars, car);
+		return;
+	}
+
+	cars.pos_x[car] = cars.prev_x[car] + move_x;
+	cars.pos_y[car] = cars.prev_y[car] + move_y;
+	cars.vel_x[car] = move_x / after;
+	cars.vel_y[car] = move_y / after;
+	cars.rot[car] = atan2(-cars.vel_x[car], cars.vel_y[car]) / piOver180;
+
+	// the box is longer than it is wide, so turning it can put the other end into the
+	// wall - then it keeps the heading it had
+	if (walls.isColliding(cars.edges(car), edges)) {
+		cars.rot[car] = cars.prev_rot[car];
+		cars.vel_x[car] = cars.prev_vel_x[car];
+		cars.vel_y[car] = cars.prev_vel_y[car];
+		if (walls.isColliding(cars.edges(car), edges)) {
+			undoMove(cars, car);
+			return;
+		}
+	}
+
+	cars.speed[car] *= after / before;
+}
+
+// whether car b is in front of car a, going by the way a is facing
+static bool isAhead(const CarPool &cars, int a, int b) {
+	float dx = cars.pos_x[b] - cars.pos_x[a], dy = cars.pos_y[b] - cars.pos_y[a];
+	return dx * cars.vel_x[a] + dy * cars.vel_y[a] > 0;
+}
+
+// a car that runs into the back of another is stopped and the one in front carries on,
+// otherwise - head on, or side by side - both are stopped. cpu cars all follow the same
+// line, and would jam solid if every nudge from behind stopped the car in front as well
+static void resolveCrash(CarPool &cars, int a, int b) {
+	bool aHitB = isAhead(cars, a, b) && !isAhead(cars, b, a);
+	bool bHitA = isAhead(cars, b, a) && !isAhead(cars, a, b);
+	if (!aHitB)
+		undoMove(cars, b);
+	if (!bHitA)
+		undoMove(cars, a);
+}
+
+// cpu cars read their heading and speed from the steering field, and turn whichever
+// way is shorter - heading errors under half a tick's turn are left alone so they
+// don't weave from side to side
+void steerCpuCars(Race &race) {
+	CarPool &cars = race.cars;
+	const SteeringField &field = race.track->steering();
+	const float deadZone = 0.5f * sin(race.tuning.rotRate * piOver180);
+	const float maxSpeed = race.tuning.maxSpeed;
+	for (size_t i = 0; i < cars.size(); i++) {
+		if (cars.playerControlled[i])
+			continue;
+
+		const SteeringCell &cell = field.at(cars.pos_x[i], cars.pos_y[i]);
+		float vx = cars.vel_x[i], vy = cars.vel_y[i];
+		float cross = vx * cell.dir_y - vy * cell.dir_x;	// positive when the heading wanted is to the left
+		float dot = vx * cell.dir_x + vy * cell.dir_y;
+
+		unsigned char c = 0;
+		if (cars.speed[i] < cell.speed * maxSpeed)
+			c |= CONTROL_ACCELERATE;
+
+		// facing the wrong way, cross can be tiny - turn left unless right is clearly shorter
+		if (cross > deadZone || (dot < 0 && cross >= 0))
+			c |= CONTROL_LEFT;
+		else if (cross < -deadZone || dot < 0)
+			c |= CONTROL_RIGHT;
+
+		cars.controls[i] |= c;
+	}
+}
+
+void stepRace(Race &race) {
+	CarPool &cars = race.cars;
+
+	// a replay sets every car's controls itself, and the race stops where the log does
+	if (race.replaying && !race.replaying->play(cars))
+		return;
+
+	if (!race.replaying) {
+		PROFILE_SCOPE("ai");
+		steerCpuCars(race);
+	}
+
+	if (race.recording)
+		race.recording->record(cars);
+
+	// speed, turning and movement for every car in one pass
+	{
+		PROFILE_SCOPE("physics");
+		updateCars(cars, race.tuning);
+	}
+
+	// collision detection against walls, by the corners and sides of each car's box
+	{
+		PROFILE_SCOPE("wall hits");
+		const DistanceField &walls = race.track->wallDistance();
+		const TrackGrid &edges = race.track->grid();
+		for (size_t i = 0; i < cars.size(); i++) {
+			if (walls.isColliding(cars.edges((int)i), edges))
+				slideAlongWall(cars, walls, edges, (int)i);
+		}
+	}
+
+	// collision detection between cars
+	{
+		PROFILE_SCOPE("car hits");
+		race.broadPhase.update(cars);
+		const std::vector<CarPair> &pairs = race.broadPhase.pairs();
+		for (size_t i = 0; i < pairs.size(); i++)
+			resolveCrash(cars, pairs[i].a, pairs[i].b);
+	}
+
+	{
+		PROFILE_SCOPE("laps");
+		for (size_t i = 0; i < cars.size(); i++) {
+			if (!cars.playerControlled[i])
+				checkWaypointHit(race, (int)i);
+		}
+		doLapTimer(race);
+		if (race.ghost)
+			race.ghost->update(race, playerCar);
+	}
+
+	race.ticks++;
+}
+
+// the circuit being raced, walls, timing lines and waypoints
+Track track;
+
+// the race in the window
+Race race;
+
+bool initTrack(const std::string &path) {
+	std::string error;
+	if (!track.load(path, error)) {
+		std::cout << "couldn't load track: " << error << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void initCars(int cpuCars, uint64_t expectedTicks) {
+	int placed = initRace(race, track, cpuCars, true, 0, expectedTicks);
+	if (placed < cpuCars + 1)
+		std::cout << "only " << placed << " cars fit on the grid of this track, not " << cpuCars + 1 << std::endl;
+}
+
+void stepSimulation() {
+	stepRace(race);
+}
+
+int runHeadless(long ticks, int cpuCars, bool checkAllocations, const std::string &trackPath, const std::string &recordPath) {
+	if (!initTrack(trackPath))
+		return 1;
+	// a short warm up lets any buffers that grow with the race reach their working size
+	const int warmUpTicks = 100;
+	initCars(cpuCars, (uint64_t)ticks + warmUpTicks);
+	CarPool &cars = race.cars;
+
+	if (!recordPath.empty())
+		startRecording(recordPath, trackPath, (uint64_t)ticks + warmUpTicks);
+
+	for (int i = 0; i < warmUpTicks; i++)
+		stepSimulation();
+#ifdef RACEGAME_PROFILE
+	profileCollect();
+#endif
+
+	size_t allocationsBefore = allocationCount();
+	auto start = std::chrono::steady_clock::now();
+
+	size_t candidates = 0, edgeTests = 0;
+	for (long i = 0; i < ticks; i++) {
+		stepSimulation();
+		candidates += race.broadPhase.candidates();
+		edgeTests += race.broadPhase.edgeTests();
+
+#ifdef RACEGAME_PROFILE
+		// nothing draws frames here to empty the rings, so it's done as the run goes
+		if ((i & 255) == 255)
+			profileCollect();
+#endif
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	size_t allocations = allocationCount() - allocationsBefore;
+
+	// report throughput along with some state, so runs can be sanity checked
+	std::cout << "cars        : " << cars.size() << std::endl;
+	std::cout << "ticks       : " << ticks << std::endl;
+	std::cout << "sim seconds : " << ticks * tickSeconds << std::endl;
+	std::cout << "wall seconds: " << elapsed.count() << std::endl;
+	std::cout << "ticks/sec   : " << (elapsed.count() > 0 ? ticks / elapsed.count() : 0) << std::endl;
+	std::cout << "car ticks/s : " << (elapsed.count() > 0 ? ticks * cars.size() / elapsed.count() : 0) << std::endl;
+	std::cout << "sweep pairs : " << (double)candidates / ticks << " per tick" << std::endl;
+	std::cout << "pair tests  : " << (double)edgeTests / ticks << " per tick" << std::endl;
+	std::cout << "allocations : " << allocations << std::endl;
+	// --cars 0 races the player's car alone
+	if (cars.size() > (size_t)cpuCar1)
+		std::cout << "cpu car     : (" << cars.pos_x[cpuCar1] << ", " << cars.pos_y[cpuCar1] << ") waypoint " << cars.nextWaypoint[cpuCar1] << std::endl;
+
+	if (!recordPath.empty() && !saveRecording())
+		return 1;
+
+	// with --check-allocs the run fails if any tick touched the heap
+	if (checkAllocations && allocations > 0) {
+		std::cout << "FAILED: simulation ticks allocated memory" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+// everything that moves the game world forward lives here, with no GL calls,
+// so it can be stepped without a window (see runHeadless)
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "geometry.h"
+#include "carpool.h"
+#include "collision.h"
+#include "broadphase.h"
+#include "track.h"
+
+// global variables
+extern float carLength;
+extern float carWidth;
+
+// pre-computed divisions
+extern float carLengthHalf;
+extern float carWidthHalf;
+extern float piOver180;
+
+// length of one simulation step - physics always advances by this much
+const float tickSeconds = 0.005f;
+
+// lap timing and race order for every car in a race, one entry per car - all of it comes
+// from how far round the track's centreline each car is, so nothing is tested against the
+// timing lines themselves
+struct LapTimers {
+	std::vector<float> current;				// seconds into the lap under way
+	std::vector<float> best;				// fastest lap, only meaningful once completed > 0
+	std::vector<int> completed;				// laps finished
+	std::vector<unsigned char> started;		// whether the car has crossed the start line yet
+
+	std::vector<int> segment;				// centreline segment the car was on last tick
+	std::vector<float> distance;			// round the lap from the start line - negative until started
+
+	// sector splits - sectors run between the sector lines, the first from the start line
+	// and the last back to it
+	size_t sectorCount = 1;
+	std::vector<int> sector;				// the sector under way
+	std::vector<float> sectorStart;			// lap time it began at
+	std::vector<float> lastSplit;			// time of the last sector finished, 0 before the first
+	std::vector<float> bestSplits;			// sectorCount per car, 0 until that sector has been timed
+
+	// race order, kept sorted tick by tick - nearly nothing changes place, so it's close
+	// to a single pass however many cars there are
+	std::vector<int> order;					// cars from the leader back
+	std::vector<int> position;				// each car's place in order, 0 for the leader
+
+	// sizes everything for a race - the cars' places on the centreline are set by initRace
+	void reset(size_t cars, size_t sectors);
+
+	float bestSplit(int car, size_t s) const { return bestSplits[car * sectorCount + s]; }
+};
+
+// one finished lap
+struct LapRecord {
+	int car;
+	float seconds;
+};
+
+class ControlLog;
+class Ghost;
+
+// one self-contained race - the cars, their timing and the rules they race by, on a
+// track that any number of races can share. nothing in here is global, so races can run
+// side by side on different threads
+struct Race {
+	const Track *track = nullptr;
+	CarTuning tuning;
+
+	CarPool cars;
+	CarBroadPhase broadPhase;
+	LapTimers laps;
+	std::vector<LapRecord> lapLog;	// every lap finished, in order
+	long ticks = 0;
+
+	ControlLog *recording = nullptr;	// when set, every tick's controls are added to it
+	ControlLog *replaying = nullptr;	// when set, every car is driven by it rather than the keys or the AI
+	Ghost *ghost = nullptr;				// when set, follows the player's laps and drives the best one back
+};
+
+// index of the human player's car (when there is one) and of the first cpu car
+const int playerCar = 0;
+const int cpuCar1 = 1;
+
+// puts the player (if humanPlayer) plus the given number of cpu cars on the starting grid
+// of a track, clearing everything from any previous race. a non-zero seed nudges each
+// car's grid slot and heading slightly, so repeated races don't play out identically.
+// room for every lap that could be finished in expectedTicks at the race's tuning is kept
+// up front, so set the tuning first. returns how many cars it put on the grid - fewer
+// than asked for when a grid that long would reach round the lap to its own front
+int initRace(Race &race, const Track &track, int cpuCars, bool humanPlayer, unsigned seed = 0, uint64_t expectedTicks = 4096);
+
+// sets the controls of every cpu car from the track's steering field - stepRace does this
+// first, unless the race is a replay
+void steerCpuCars(Race &race);
+
+// advances a race by one fixed tick of tickSeconds - a replay that has run out stays where it is
+void stepRace(Race &race);
+
+// does circle/circle collision detection to determine whether a car has hit its waypoint -
+// cpu cars steer by the track's steering field, this only tracks progress for the debug view
+void checkWaypointHit(Race &race, int car);
+
+// moves every car along the centreline, then times laps and sectors and puts the cars in
+// race order - crossing the first start line ends one lap and begins the next
+void doLapTimer(Race &race);
+
+// the race in the window, and the circuit it runs on
+extern Track track;
+extern Race race;
+
+// the track raced unless --track picks another
+const char *const defaultTrackPath = "tracks/default.track";
+
+// loads the track from a text or compiled track file, returns false (printing why) if it can't
+bool initTrack(const std::string &path = defaultTrackPath);
+
+// resets the window's race to the player plus the given number of cpu cars, or as many as
+// fit on the grid, saying so when that's fewer
+void initCars(int cpuCars, uint64_t expectedTicks = 4096);
+
+// advances the window's race by one tick
+void stepSimulation();
+
+// runs the given number of ticks as fast as possible with no window or GL context,
+// then prints the throughput - returns the process exit code, which is non-zero if
+// checkAllocations is set and any tick allocated memory. with a recordPath the run's
+// controls are logged there, to replay later
+int runHeadless(long ticks, int cpuCars, bool checkAllocations, const std::string &trackPath = defaultTrackPath,
+	const std::string &recordPath = std::string());
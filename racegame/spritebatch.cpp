@@ -0,0 +1,231 @@
+#include "spritebatch.h"
+
+int drawCalls = 0;
+
+void CachedTexture::set(TextureCache &textureCache, int textureHandle) {
+	cache = &textureCache;
+	handle = textureHandle;
+	uploaded = false;
+}
+
+GLuint CachedTexture::texture() {
+	if (uploaded || !cache)
+		return id;
+	uploaded = true;
+
+	const TextureImage &image = cache->image(handle);
+	if (image.empty())
+		return 0;
+
+	// every level comes from the cache, nothing is generated here
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levels - 1);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	for (int level = 0; level < image.levels; level++) {
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, image.levelWidth(level), image.levelHeight(level), 0,
+			GL_RGBA, GL_UNSIGNED_BYTE, image.pixels + image.levelOffset(level));
+	}
+
+	return id;
+}
+
+const AtlasRegion &CachedTexture::region(size_t i) {
+	// a texture that failed to load draws untextured, from anywhere
+	static const AtlasRegion none = { 0, 0, 0, 0 };
+	if (!cache)
+		return none;
+
+	const TextureImage &image = cache->image(handle);
+	return i < image.regions.size() ? image.regions[i] : none;
+}
+
+void SpriteBatch::add(const point corners[4], const AtlasRegion &region) {
+	dirty = true;
+	vertices.push_back({ corners[0].x, corners[0].y, region.u0, region.v0 }); // bottom left
+	vertices.push_back({ corners[1].x, corners[1].y, region.u0, region.v1 }); // top left
+	vertices.push_back({ corners[2].x, corners[2].y, region.u1, region.v1 }); // top right
+	vertices.push_back({ corners[3].x, corners[3].y, region.u1, region.v0 }); // bottom right
+}
+
+void SpriteBatch::begin(GLuint texture) {
+	if (!buffer)
+		glGenBuffers(1, &buffer);
+
+	// a streamed batch gives the driver a fresh buffer each frame rather than waiting on
+	// last frame's, a kept one only uploads when it has been rebuilt
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	if (dirty) {
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(SpriteVertex), vertices.data(), usage);
+		dirty = false;
+	}
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(SpriteVertex), (const GLvoid *)0);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(SpriteVertex), (const GLvoid *)(2 * sizeof(float)));
+}
+
+void SpriteBatch::end() {
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glDisable(GL_TEXTURE_2D);
+}
+
+void SpriteBatch::draw(GLuint texture) {
+	if (vertices.empty())
+		return;
+
+	begin(texture);
+	glDrawArrays(GL_QUADS, 0, (GLsizei)vertices.size());
+	drawCalls++;
+	end();
+}
+
+void SpriteBatch::draw(GLuint texture, const std::vector<GLint> &firsts, const std::vector<GLsizei> &counts) {
+	if (vertices.empty() || firsts.empty())
+		return;
+
+	begin(texture);
+	glMultiDrawArrays(GL_QUADS, firsts.data(), counts.data(), (GLsizei)firsts.size());
+	drawCalls++;
+	end();
+}
+
+// glyphs side by side along one row, a pixel apart so filtering never bleeds one into the next
+void GlyphAtlas::build() {
+	built = true;
+	int width = 0;
+	for (int c = 0; c < 95; c++)
+		width += font.glyphs[c][0] + 1;
+
+	atlasWidth = 1;
+	while (atlasWidth < width)
+		atlasWidth *= 2;
+	atlasHeight = 1;
+	while (atlasHeight < font.height)
+		atlasHeight *= 2;
+	pixels.assign((size_t)atlasWidth * atlasHeight, 0);
+
+	// glyph rows run bottom up, most significant bit on the left, as glBitmap takes them -
+	// kept bottom up here, so v grows up the glyph
+	int x = 0;
+	for (int c = 0; c < 95; c++) {
+		const unsigned char *glyph = font.glyphs[c];
+		int glyphWidth = glyph[0], rowBytes = (glyphWidth + 7) / 8;
+		for (int row = 0; row < font.height; row++) {
+			const unsigned char *bits = glyph + 1 + row * rowBytes;
+			for (int column = 0; column < glyphWidth; column++) {
+				if (bits[column / 8] & (0x80 >> (column % 8)))
+					pixels[(size_t)row * atlasWidth + x + column] = 255;
+			}
+		}
+
+		regions[c] = { (float)x / atlasWidth, 0.0f, (float)(x + glyphWidth) / atlasWidth, (float)font.height / atlasHeight };
+		x += glyphWidth + 1;
+	}
+}
+
+GLuint GlyphAtlas::texture() {
+	if (id)
+		return id;
+	if (!built)
+		build();
+
+	// alpha only - drawn with the current colour, as glBitmap text was
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlasWidth, atlasHeight, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	std::vector<unsigned char>().swap(pixels);
+	return id;
+}
+
+float GlyphAtlas::layout(SpriteBatch &batch, const char *text, float x, float y, float scale, bool yDown) {
+	if (!built)
+		build();
+
+	// the glyph's box reaches descent pixels below the baseline
+	float down = yDown ? scale : -scale;
+	float bottom = y - font.descent * down;
+	float top = bottom + font.height * down;
+
+	for (const char *c = text; *c; c++) {
+		unsigned char character = (unsigned char)*c;
+		if (character < ' ' || character > '~')
+			continue;
+
+		int glyph = character - ' ';
+		float advance = font.glyphs[glyph][0] * scale;
+		if (character != ' ') {
+			point corners[4] = { { x, bottom }, { x, top }, { x + advance, top }, { x + advance, bottom } };
+			batch.add(corners, regions[glyph]);
+		}
+		x += advance;
+	}
+	return x;
+}
+
+void LineBatch::clear() {
+	vertices.clear();
+	dirty = true;
+}
+
+void LineBatch::add(point p1, point p2) {
+	vertices.push_back(p1);
+	vertices.push_back(p2);
+	dirty = true;
+}
+
+void LineBatch::begin() {
+	if (!buffer)
+		glGenBuffers(1, &buffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	if (dirty) {
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(point), vertices.data(), usage);
+		dirty = false;
+	}
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(point), (const GLvoid *)0);
+}
+
+void LineBatch::end() {
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void LineBatch::draw() {
+	if (vertices.empty())
+		return;
+
+	begin();
+	glDrawArrays(GL_LINES, 0, (GLsizei)vertices.size());
+	drawCalls++;
+	end();
+}
+
+void LineBatch::draw(const std::vector<GLint> &firsts, const std::vector<GLsizei> &counts) {
+	if (vertices.empty() || firsts.empty())
+		return;
+
+	begin();
+	glMultiDrawArrays(GL_LINES, firsts.data(), counts.data(), (GLsizei)firsts.size());
+	drawCalls++;
+	end();
+}
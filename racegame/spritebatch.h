@@ -0,0 +1,127 @@
+#pragma once
+
+// batched drawing - sprites are packed into one atlas texture, and quads and lines are
+// written into vertex buffers so a whole layer goes out in a single draw call
+
+#include <vector>
+#include "graphics.h"
+#include "geometry.h"
+#include "texturecache.h"
+#include "font.h"
+
+// a texture served by a TextureCache, uploaded with its whole mip chain the first time
+// it's drawn rather than at startup
+class CachedTexture {
+public:
+	explicit CachedTexture(GLenum wrap = GL_CLAMP_TO_EDGE) : wrap(wrap) {}
+
+	void set(TextureCache &textureCache, int handle);
+
+	// the GL texture, uploading it on the first call - 0 if the image couldn't be loaded
+	GLuint texture();
+
+	// region of the i-th source image, for atlases
+	const AtlasRegion &region(size_t i);
+
+private:
+	GLenum wrap;
+	TextureCache *cache = nullptr;
+	int handle = -1;
+	GLuint id = 0;
+	bool uploaded = false;
+};
+
+struct SpriteVertex {
+	float x, y, u, v;
+};
+
+// textured quads from one atlas, transformed on the cpu - streamed to the gpu each frame
+// for sprites that move, uploaded only when changed for ones that don't (cached text)
+class SpriteBatch {
+public:
+	// GL_STREAM_DRAW for quads rebuilt every frame, GL_STATIC_DRAW or GL_DYNAMIC_DRAW for
+	// ones that are kept between frames
+	explicit SpriteBatch(GLenum usage = GL_STREAM_DRAW) : usage(usage) {}
+
+	void clear() { vertices.clear(); dirty = true; }
+
+	// corners in the order bottom left, top left, top right, bottom right - the image's
+	// top row is drawn along the bottom edge, as the original car quads were
+	void add(const point corners[4], const AtlasRegion &region);
+
+	// draws everything added since clear() in one call, uploading first if anything changed
+	void draw(GLuint texture);
+
+	// draws only the given runs of quads, still in one call - firsts and counts are in
+	// vertices, four to a quad
+	void draw(GLuint texture, const std::vector<GLint> &firsts, const std::vector<GLsizei> &counts);
+
+	size_t size() const { return vertices.size() / 4; }
+
+private:
+	GLenum usage;
+	GLuint buffer = 0;
+	std::vector<SpriteVertex> vertices;
+	bool dirty = true;
+
+	// uploads if needed and sets up the arrays, and puts everything back afterwards
+	void begin(GLuint texture);
+	void end();
+};
+
+// every printable glyph of a bitmap font packed into one texture, so text is laid out as
+// quads in a SpriteBatch and a whole block of it draws in one call, rather than a
+// glBitmap per character
+class GlyphAtlas {
+public:
+	explicit GlyphAtlas(const BitmapFont &font) : font(font) {}
+
+	// the atlas, built and uploaded on the first call
+	GLuint texture();
+
+	// adds text with its baseline starting at (x, y), each pixel of the font scale units
+	// across - yDown for a screen space projection where y grows down the screen. returns
+	// where the next character would go
+	float layout(SpriteBatch &batch, const char *text, float x, float y, float scale = 1.0f, bool yDown = false);
+
+private:
+	const BitmapFont &font;
+	GLuint id = 0;
+	bool built = false;
+	AtlasRegion regions[95];
+	int atlasWidth = 0, atlasHeight = 0;
+	std::vector<unsigned char> pixels;	// alpha only, kept until uploaded
+
+	void build();
+};
+
+// untextured lines - static ones (the track) upload once, streamed ones (debug boxes)
+// upload whenever they have changed
+class LineBatch {
+public:
+	// GL_STATIC_DRAW for lines that are built once, GL_STREAM_DRAW for ones rebuilt every frame
+	explicit LineBatch(GLenum usage = GL_STATIC_DRAW) : usage(usage) {}
+
+	void clear();
+	void add(point p1, point p2);
+	void add(const edge &e) { add(e.p1, e.p2); }
+
+	// draws every line in one call, uploading first if anything changed
+	void draw();
+
+	// draws only the given runs of lines, still in one call - firsts and counts are in
+	// vertices, two to a line
+	void draw(const std::vector<GLint> &firsts, const std::vector<GLsizei> &counts);
+
+	size_t size() const { return vertices.size() / 2; }
+
+private:
+	GLenum usage;
+	GLuint buffer = 0;
+	std::vector<point> vertices;
+	bool dirty = true;
+
+	// uploads if needed and sets up the arrays, and puts everything back afterwards
+	void begin();
+	void end();
+};
@@ -0,0 +1,184 @@
+#include "steering.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// how far round the loop each cell aims - further cuts corners more, walls pull it back in
+static const float lookAhead = 6.0f;
+
+// how far ahead the loop is checked for corners worth slowing for
+static const float brakeDistance = 8.0f;
+
+// how far from the loop cells are stored - comfortably more than any road is wide
+static const float reach = 10.0f;
+
+// a cell off the road, cars there just keep going
+static const SteeringCell offRoad = { 0.0f, 0.0f, 1.0f };
+
+// how much room a path needs either side to count as clear - a car is half a unit wide
+// and a unit long, and cars anywhere in the cell share its heading
+static const float clearance = 0.75f;
+
+// whether a car could drive from a to b without touching a wall - the line itself and
+// two more either side of it, clearance away
+static bool clearPath(const TrackGrid &grid, point a, point b) {
+	float dx = b.x - a.x, dy = b.y - a.y, length = sqrt(dx * dx + dy * dy);
+	if (length <= 0)
+		return true;
+
+	float ox = -dy / length * clearance, oy = dx / length * clearance;
+	edge lines[3] = {
+		{ a, b },
+		{ { a.x + ox, a.y + oy }, { b.x + ox, b.y + oy } },
+		{ { a.x - ox, a.y - oy }, { b.x - ox, b.y - oy } },
+	};
+	return !grid.isColliding(EdgeSpan(lines, 3));
+}
+
+// where a cell's centre sits on the loop, as distance from the first waypoint
+struct LoopPosition {
+	float along;
+	float dist2;
+	point nearest;
+};
+
+void SteeringField::build(ArrayView<point> waypoints, const TrackGrid &grid, float size) {
+	cells.reset(size, offRoad);
+	if (waypoints.empty())
+		return;
+
+	// the waypoints as a closed loop, with the distance round it to the start of each leg
+	size_t legs = waypoints.size();
+	std::vector<float> legStart(legs + 1, 0.0f);
+	for (size_t i = 0; i < legs; i++) {
+		const point &a = waypoints[i], &b = waypoints[(i + 1) % legs];
+		legStart[i + 1] = legStart[i] + sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+	}
+	float loopLength = legStart[legs];
+
+	// the leg a distance round the loop falls on, and how far along it
+	auto legAt = [&](float along, float &t) {
+		along = fmod(along, loopLength);
+		if (along < 0)
+			along += loopLength;
+		size_t leg = std::upper_bound(legStart.begin(), legStart.end(), along) - legStart.begin() - 1;
+		leg = std::min(leg, legs - 1);
+		float length = legStart[leg + 1] - legStart[leg];
+		t = length > 0 ? (along - legStart[leg]) / length : 0.0f;
+		return leg;
+	};
+	auto pointAt = [&](float along) {
+		float t;
+		size_t leg = legAt(along, t);
+		const point &a = waypoints[leg], &b = waypoints[(leg + 1) % legs];
+		return point{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+	};
+	auto directionAt = [&](float along) {
+		float t;
+		size_t leg = legAt(along, t);
+		const point &a = waypoints[leg], &b = waypoints[(leg + 1) % legs];
+		float dx = b.x - a.x, dy = b.y - a.y, length = sqrt(dx * dx + dy * dy);
+		return length > 0 ? point{ dx / length, dy / length } : point{ 0.0f, 1.0f };
+	};
+
+	// the nearest point on a leg to p, and how far round the loop it is
+	auto nearestOnLeg = [&](size_t leg, point p) {
+		const point &a = waypoints[leg], &b = waypoints[(leg + 1) % legs];
+		float dx = b.x - a.x, dy = b.y - a.y, length2 = dx * dx + dy * dy;
+		float t = length2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length2 : 0.0f;
+		t = std::max(0.0f, std::min(1.0f, t));
+
+		point q = { a.x + dx * t, a.y + dy * t };
+		LoopPosition position = { legStart[leg] + t * (legStart[leg + 1] - legStart[leg]),
+			(q.x - p.x) * (q.x - p.x) + (q.y - p.y) * (q.y - p.y), q };
+		return position;
+	};
+
+	// every tile within reach of a leg, along with the legs near each tile - cells only
+	// search those
+	typedef TileMap<SteeringCell> Tiles;
+	const float tileUnits = Tiles::tileSize * size;
+	const float tileReach = reach + tileUnits * 0.7072f;	// out to a tile's far corner
+	std::vector<std::vector<uint32_t>> nearLegs;
+	for (size_t leg = 0; leg < legs; leg++) {
+		const point &a = waypoints[leg], &b = waypoints[(leg + 1) % legs];
+		int firstColumn = (int)floor((std::min(a.x, b.x) - reach) / tileUnits);
+		int lastColumn = (int)floor((std::max(a.x, b.x) + reach) / tileUnits);
+		int firstRow = (int)floor((std::min(a.y, b.y) - reach) / tileUnits);
+		int lastRow = (int)floor((std::max(a.y, b.y) + reach) / tileUnits);
+
+		for (int ty = firstRow; ty <= lastRow; ty++) {
+			for (int tx = firstColumn; tx <= lastColumn; tx++) {
+				point centre = { (tx + 0.5f) * tileUnits, (ty + 0.5f) * tileUnits };
+				if (nearestOnLeg(leg, centre).dist2 > tileReach * tileReach)
+					continue;
+
+				uint32_t tile = cells.addTile(tx, ty);
+				if (tile >= nearLegs.size())
+					nearLegs.resize(tile + 1);
+				nearLegs[tile].push_back((uint32_t)leg);
+			}
+		}
+	}
+
+	for (uint32_t tile = 0; tile < cells.tileCount(); tile++) {
+		int tx, ty;
+		cells.tileCoords(tile, tx, ty);
+		SteeringCell *tileCells = cells.tileCellsFor(tile);
+		const std::vector<uint32_t> &candidates = nearLegs[tile];
+
+		for (int row = 0; row < Tiles::tileSize; row++) {
+			for (int column = 0; column < Tiles::tileSize; column++) {
+				point corner = cells.cellCorner(tx * Tiles::tileSize + column, ty * Tiles::tileSize + row);
+				point centre = { corner.x + 0.5f * size, corner.y + 0.5f * size };
+
+				// the nearest point on the loop that can be seen from here - or just the
+				// nearest, for cells behind a wall that nothing can reach anyway
+				LoopPosition visible = { 0, INFINITY, centre }, closest = { 0, INFINITY, centre };
+				for (size_t i = 0; i < candidates.size(); i++) {
+					LoopPosition position = nearestOnLeg(candidates[i], centre);
+					if (position.dist2 < closest.dist2)
+						closest = position;
+					if (position.dist2 < visible.dist2 && !grid.isColliding(edge{ centre, position.nearest }))
+						visible = position;
+				}
+				if (closest.dist2 > reach * reach)
+					continue;
+				const LoopPosition &here = visible.dist2 < INFINITY ? visible : closest;
+
+				// aim further round, halving the distance until the way there is clear
+				point target = here.nearest;
+				for (float ahead = lookAhead; ahead >= 0.25f; ahead *= 0.5f) {
+					point candidate = pointAt(here.along + ahead);
+					if (clearPath(grid, centre, candidate)) {
+						target = candidate;
+						break;
+					}
+				}
+
+				SteeringCell &cell = tileCells[row * Tiles::tileSize + column];
+				float dx = target.x - centre.x, dy = target.y - centre.y, length = sqrt(dx * dx + dy * dy);
+				if (length > 0.01f) {
+					cell.dir_x = dx / length;
+					cell.dir_y = dy / length;
+				}
+				else {
+					point along = directionAt(here.along);
+					cell.dir_x = along.x;
+					cell.dir_y = along.y;
+				}
+
+				// ease off before a corner - full speed up to 45 degrees of turn, half by a hairpin
+				point now = directionAt(here.along), later = directionAt(here.along + brakeDistance);
+				float turn = acos(std::max(-1.0f, std::min(1.0f, now.x * later.x + now.y * later.y))) * 180.0f / 3.14159265359f;
+				cell.speed = 1.0f - 0.5f * std::max(0.0f, (turn - 45.0f) / 135.0f);
+			}
+		}
+	}
+
+	cells.finish();
+}
+
+bool SteeringField::attach(float size, ArrayView<TileSlot> slots, ArrayView<SteeringCell> stored) {
+	return cells.attach(size, offRoad, slots, stored);
+}
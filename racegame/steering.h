@@ -0,0 +1,42 @@
+#pragma once
+
+// a flow field for the cpu cars - the road is covered in cells, and each one holds the
+// heading a car there should drive along and how fast it should go, worked out once from
+// the waypoints. steering is then a table lookup and a cross product rather than trig
+// against the next waypoint every tick
+
+#include <cstdint>
+#include <vector>
+#include "geometry.h"
+#include "collision.h"
+#include "tilemap.h"
+
+struct SteeringCell {
+	float dir_x, dir_y;		// unit heading to drive along
+	float speed;			// fraction of top speed to hold, lower before tight corners
+};
+
+class SteeringField {
+public:
+	// bakes the field along the waypoint loop - each cell aims at a point a little further
+	// round the loop, pulled back until no wall is in the way. only cells within reach of
+	// the loop are stored, so the field grows with the length of the circuit
+	void build(ArrayView<point> waypoints, const TrackGrid &grid, float cellSize = 1.0f);
+
+	// uses cells baked earlier and stored elsewhere, such as in a compiled track file -
+	// nothing is copied, so the arrays have to outlive the field
+	bool attach(float cellSize, ArrayView<TileSlot> slots, ArrayView<SteeringCell> cells);
+
+	// the cell under a point - away from the road there is no heading, only full throttle
+	const SteeringCell &at(float x, float y) const { return cells.at(x, y); }
+
+	bool empty() const { return cells.empty(); }
+
+	// what attach() needs to rebuild this field
+	float cell() const { return cells.cell(); }
+	ArrayView<TileSlot> slots() const { return cells.slots(); }
+	ArrayView<SteeringCell> storedCells() const { return cells.storedCells(); }
+
+private:
+	TileMap<SteeringCell> cells;
+};
@@ -0,0 +1,338 @@
+#include "texturecache.h"
+#include <SOIL.h> // include the SOIL header file (for loading images)
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+// file layout: a header, one entry per texture, then each entry's atlas regions and
+// pixels wherever its offsets say - pixels start on 16 byte boundaries
+struct CacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t count;
+	uint32_t reserved;
+};
+
+struct CacheEntry {
+	char name[48];
+	uint64_t stamp;
+	uint32_t width, height, levels, regionCount;
+	uint64_t regionOffset, pixelOffset;
+};
+
+static const char cacheMagic[4] = { 'R', 'G', 'T', 'X' };
+static const uint32_t cacheVersion = 1;
+
+// transparent gap left around each atlas image, so mipmapping doesn't bleed neighbours together
+static const int atlasPadding = 4;
+
+size_t TextureImage::levelOffset(int level) const {
+	size_t offset = 0;
+	for (int i = 0; i < level; i++)
+		offset += (size_t)levelWidth(i) * levelHeight(i) * 4;
+	return offset;
+}
+
+// fnv-1a over the size and modification time of every source file, so editing an image
+// invalidates its entry - 0 if any source is missing
+static uint64_t sourceStamp(const std::vector<std::string> &files, bool atlas) {
+	uint64_t hash = 14695981039346656037ULL;
+	auto mix = [&](uint64_t value) {
+		for (int i = 0; i < 8; i++) {
+			hash ^= (value >> (i * 8)) & 0xff;
+			hash *= 1099511628211ULL;
+		}
+	};
+
+	mix(atlas ? atlasPadding : 0);
+	for (size_t i = 0; i < files.size(); i++) {
+		struct stat info;
+		if (stat(files[i].c_str(), &info) != 0)
+			return 0;
+		mix((uint64_t)info.st_size);
+		mix((uint64_t)info.st_mtime);
+	}
+	return hash;
+}
+
+// fills in every level below 0 by averaging 2x2 blocks of the level above, then points
+// pixels at the chain - owned must hold level 0 on entry
+static void buildMipChain(TextureImage &image) {
+	image.levels = 1;
+	while (image.levelWidth(image.levels - 1) > 1 || image.levelHeight(image.levels - 1) > 1)
+		image.levels++;
+
+	image.owned.resize(image.levelOffset(image.levels));
+	for (int level = 1; level < image.levels; level++) {
+		const unsigned char *src = &image.owned[image.levelOffset(level - 1)];
+		unsigned char *dst = &image.owned[image.levelOffset(level)];
+		int srcWidth = image.levelWidth(level - 1), srcHeight = image.levelHeight(level - 1);
+		int width = image.levelWidth(level), height = image.levelHeight(level);
+
+		for (int y = 0; y < height; y++) {
+			// odd sizes repeat the last row or column
+			int y0 = std::min(y * 2, srcHeight - 1), y1 = std::min(y * 2 + 1, srcHeight - 1);
+			for (int x = 0; x < width; x++) {
+				int x0 = std::min(x * 2, srcWidth - 1), x1 = std::min(x * 2 + 1, srcWidth - 1);
+				for (int c = 0; c < 4; c++) {
+					int sum = src[(y0 * srcWidth + x0) * 4 + c] + src[(y0 * srcWidth + x1) * 4 + c] +
+						src[(y1 * srcWidth + x0) * 4 + c] + src[(y1 * srcWidth + x1) * 4 + c];
+					dst[(y * width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+
+	image.pixels = image.owned.data();
+}
+
+// loads every source image, packing them into an atlas if asked - leaves the image
+// empty if any file fails to load
+static void decodeTexture(const std::vector<std::string> &files, bool atlas, TextureImage &result) {
+	struct Image {
+		unsigned char *pixels;
+		int width, height;
+		int x, y;
+	};
+
+	std::vector<Image> images(files.size());
+	bool loaded = true;
+	for (size_t i = 0; i < files.size(); i++) {
+		int channels;
+		images[i].pixels = SOIL_load_image(files[i].c_str(), &images[i].width, &images[i].height, &channels, SOIL_LOAD_RGBA);
+		if (!images[i].pixels)
+			loaded = false;
+	}
+
+	if (!loaded || images.empty()) {
+		for (size_t i = 0; i < images.size(); i++)
+			SOIL_free_image_data(images[i].pixels);
+		return;
+	}
+
+	int width, height;
+	if (!atlas) {
+		width = images[0].width;
+		height = images[0].height;
+		images[0].x = images[0].y = 0;
+	}
+	else {
+		// shelf packing - tallest first, left to right, starting a new shelf when a row is full
+		std::vector<size_t> order(images.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return images[a].height > images[b].height; });
+
+		width = 512;
+		for (size_t i = 0; i < images.size(); i++) {
+			while (width < images[i].width + atlasPadding * 2)
+				width *= 2;
+		}
+
+		int x = atlasPadding, y = atlasPadding, shelfHeight = 0;
+		for (size_t i = 0; i < order.size(); i++) {
+			Image &image = images[order[i]];
+			if (x + image.width + atlasPadding > width) {
+				x = atlasPadding;
+				y += shelfHeight + atlasPadding;
+				shelfHeight = 0;
+			}
+			image.x = x;
+			image.y = y;
+			x += image.width + atlasPadding;
+			shelfHeight = std::max(shelfHeight, image.height);
+		}
+
+		height = 1;
+		while (height < y + shelfHeight + atlasPadding)
+			height *= 2;
+	}
+
+	// copy each image in row by row
+	result.width = width;
+	result.height = height;
+	result.owned.assign((size_t)width * height * 4, 0);
+	result.regions.resize(atlas ? images.size() : 0);
+	for (size_t i = 0; i < images.size(); i++) {
+		const Image &image = images[i];
+		for (int row = 0; row < image.height; row++)
+			memcpy(&result.owned[((size_t)(image.y + row) * width + image.x) * 4], &image.pixels[(size_t)row * image.width * 4], image.width * 4);
+
+		if (atlas) {
+			result.regions[i].u0 = (float)image.x / width;
+			result.regions[i].v0 = (float)image.y / height;
+			result.regions[i].u1 = (float)(image.x + image.width) / width;
+			result.regions[i].v1 = (float)(image.y + image.height) / height;
+		}
+
+		SOIL_free_image_data(image.pixels);
+	}
+
+	buildMipChain(result);
+}
+
+TextureCache::~TextureCache() {
+	for (size_t i = 0; i < textures.size(); i++) {
+		if (textures[i]->worker.joinable())
+			textures[i]->worker.join();
+	}
+}
+
+void TextureCache::open(const std::string &cachePath) {
+	path = cachePath;
+	if (!file.open(path.c_str()))
+		return;
+
+	// anything that doesn't look like this version's cache is ignored, and rebuilt by save()
+	const CacheHeader *header = (const CacheHeader *)file.data();
+	if (file.size() < sizeof(CacheHeader) || memcmp(header->magic, cacheMagic, 4) != 0 ||
+		header->version != cacheVersion ||
+		file.size() < sizeof(CacheHeader) + (size_t)header->count * sizeof(CacheEntry))
+		file.close();
+}
+
+int TextureCache::requestImage(const std::string &name, const std::string &source) {
+	return request(name, std::vector<std::string>(1, source), false);
+}
+
+int TextureCache::requestAtlas(const std::string &name, const std::vector<std::string> &files) {
+	return request(name, files, true);
+}
+
+int TextureCache::request(const std::string &name, const std::vector<std::string> &files, bool atlas) {
+	std::unique_ptr<Texture> texture(new Texture());
+	texture->name = name;
+	texture->files = files;
+	texture->atlas = atlas;
+	texture->stamp = sourceStamp(files, atlas);
+
+	// a cached entry is used if it matches the sources, or if the sources aren't shipped
+	const CacheEntry *entry = nullptr;
+	if (file.isOpen()) {
+		const CacheHeader *header = (const CacheHeader *)file.data();
+		const CacheEntry *entries = (const CacheEntry *)(header + 1);
+		for (uint32_t i = 0; i < header->count; i++) {
+			if (strncmp(entries[i].name, name.c_str(), sizeof(entries[i].name)) == 0 &&
+				(texture->stamp == 0 || entries[i].stamp == texture->stamp)) {
+				entry = &entries[i];
+				break;
+			}
+		}
+	}
+
+	if (entry) {
+		TextureImage &image = texture->image;
+		image.width = (int)entry->width;
+		image.height = (int)entry->height;
+		image.levels = (int)entry->levels;
+
+		// an entry running off the end of the file is treated as missing
+		size_t regionBytes = entry->regionCount * sizeof(AtlasRegion);
+		if (entry->regionOffset + regionBytes <= file.size() &&
+			entry->pixelOffset + image.levelOffset(image.levels) <= file.size()) {
+			const AtlasRegion *regions = (const AtlasRegion *)(file.data() + entry->regionOffset);
+			image.regions.assign(regions, regions + entry->regionCount);
+			image.pixels = file.data() + entry->pixelOffset;
+			cached++;
+		}
+		else
+			entry = nullptr;
+	}
+
+	if (!entry) {
+		if (texture->stamp == 0)
+			return -1;
+
+		Texture *decoding = texture.get();
+		decoding->worker = std::thread([decoding]() {
+			decodeTexture(decoding->files, decoding->atlas, decoding->image);
+		});
+	}
+
+	textures.push_back(std::move(texture));
+	return (int)textures.size() - 1;
+}
+
+const TextureImage &TextureCache::image(int texture) {
+	Texture &t = *textures[texture];
+	if (t.worker.joinable())
+		t.worker.join();
+	return t.image;
+}
+
+bool TextureCache::save() {
+	std::string temporaryPath = path + ".tmp";
+	FILE *out = fopen(temporaryPath.c_str(), "wb");
+	if (!out)
+		return false;
+
+	// lay the file out first: header and entries, then each texture's regions and pixels
+	std::vector<CacheEntry> entries;
+	uint64_t offset = sizeof(CacheHeader) + textures.size() * sizeof(CacheEntry);
+	for (size_t i = 0; i < textures.size(); i++) {
+		const TextureImage &texture = image((int)i);
+		if (texture.empty())
+			continue;
+
+		CacheEntry entry;
+		memset(&entry, 0, sizeof(entry));
+		strncpy(entry.name, textures[i]->name.c_str(), sizeof(entry.name) - 1);
+		entry.stamp = textures[i]->stamp;
+		entry.width = texture.width;
+		entry.height = texture.height;
+		entry.levels = texture.levels;
+		entry.regionCount = (uint32_t)texture.regions.size();
+		entry.regionOffset = offset;
+		offset += texture.regions.size() * sizeof(AtlasRegion);
+		offset = (offset + 15) & ~(uint64_t)15;
+		entry.pixelOffset = offset;
+		offset += texture.levelOffset(texture.levels);
+		entries.push_back(entry);
+	}
+
+	CacheHeader header;
+	memcpy(header.magic, cacheMagic, 4);
+	header.version = cacheVersion;
+	header.count = (uint32_t)entries.size();
+	header.reserved = 0;
+
+	// skipped textures leave a gap after the entries, which the offsets step over
+	bool written = fwrite(&header, sizeof(header), 1, out) == 1;
+	if (!entries.empty())
+		written = written && fwrite(entries.data(), sizeof(CacheEntry), entries.size(), out) == entries.size();
+
+	size_t entry = 0;
+	for (size_t i = 0; i < textures.size() && written; i++) {
+		const TextureImage &texture = textures[i]->image;
+		if (texture.empty())
+			continue;
+
+		fseek(out, (long)entries[entry].regionOffset, SEEK_SET);
+		if (!texture.regions.empty())
+			written = fwrite(texture.regions.data(), sizeof(AtlasRegion), texture.regions.size(), out) == texture.regions.size();
+		fseek(out, (long)entries[entry].pixelOffset, SEEK_SET);
+		written = written && fwrite(texture.pixels, texture.levelOffset(texture.levels), 1, out) == 1;
+		entry++;
+	}
+
+	written = fclose(out) == 0 && written;
+	if (!written) {
+		remove(temporaryPath.c_str());
+		return false;
+	}
+
+	// textures still pointing into the old mapping take their own copy before it goes
+	for (size_t i = 0; i < textures.size(); i++) {
+		TextureImage &texture = textures[i]->image;
+		if (!texture.empty() && texture.owned.empty()) {
+			texture.owned.assign(texture.pixels, texture.pixels + texture.levelOffset(texture.levels));
+			texture.pixels = texture.owned.data();
+		}
+	}
+	file.close();
+
+	// windows won't rename over an existing file
+	remove(path.c_str());
+	return rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
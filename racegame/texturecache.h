@@ -0,0 +1,76 @@
+#pragma once
+
+// textures baked ahead of time into one file of raw RGBA, every mip level included, so
+// startup maps the file and hands the pixels straight to GL with nothing to decode -
+// anything the cache lacks, or that's older than its source images, is decoded on a
+// worker thread instead, and save() writes it back for next time
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mappedfile.h"
+
+// where one image ended up in an atlas, in texture coordinates - v0 is the image's top row
+struct AtlasRegion {
+	float u0, v0, u1, v1;
+};
+
+// one texture - mip level 0 first, then each smaller level straight after the one before
+struct TextureImage {
+	int width = 0, height = 0, levels = 0;
+	const unsigned char *pixels = nullptr;	// into the mapped cache, or into owned
+	std::vector<unsigned char> owned;		// holds the pixels when they were decoded
+	std::vector<AtlasRegion> regions;		// where each source image sits, for atlases
+
+	bool empty() const { return pixels == nullptr; }
+
+	int levelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+	int levelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+
+	// bytes from pixels to the start of the given level, or the whole chain for levels
+	size_t levelOffset(int level) const;
+};
+
+class TextureCache {
+public:
+	~TextureCache();
+
+	// maps the cache file - a missing or unreadable one is the same as an empty cache
+	void open(const std::string &cachePath);
+
+	// asks for one image, or for several packed into an atlas, under a name unique in the
+	// cache - returns a handle for image(), or -1 if it isn't cached and the sources are
+	// missing. decoding starts straight away on a worker thread when needed
+	int requestImage(const std::string &name, const std::string &source);
+	int requestAtlas(const std::string &name, const std::vector<std::string> &files);
+
+	// the texture's pixels, waiting for its decode to finish - empty if the decode failed
+	const TextureImage &image(int texture);
+
+	// textures that came from the cache and that had to be decoded
+	int cachedCount() const { return cached; }
+	int decodedCount() const { return (int)textures.size() - cached; }
+
+	// writes every requested texture out to the cache file, waiting for any still
+	// decoding - returns false if the file couldn't be written
+	bool save();
+
+private:
+	struct Texture {
+		std::string name;
+		std::vector<std::string> files;
+		bool atlas;
+		uint64_t stamp;		// sizes and times of the source files, to spot stale entries
+		TextureImage image;
+		std::thread worker;
+	};
+
+	int request(const std::string &name, const std::vector<std::string> &files, bool atlas);
+
+	std::string path;
+	MappedFile file;
+	std::vector<std::unique_ptr<Texture>> textures;	// pointers stay put while workers run
+	int cached = 0;
+};
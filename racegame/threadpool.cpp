@@ -0,0 +1,98 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(unsigned threads) : queued(0), pending(0) {
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+
+	for (unsigned i = 0; i < threads; i++)
+		queues.push_back(std::unique_ptr<Queue>(new Queue()));
+	for (unsigned i = 0; i < threads; i++)
+		workers.push_back(std::thread(&ThreadPool::run, this, i));
+}
+
+ThreadPool::~ThreadPool() {
+	wait();
+
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+void ThreadPool::submit(std::function<void()> job) {
+	pending++;
+
+	Queue &queue = *queues[nextQueue];
+	nextQueue = (nextQueue + 1) % queues.size();
+	{
+		std::lock_guard<std::mutex> lock(queue.lock);
+		queue.jobs.push_back(std::move(job));
+	}
+
+	// counted under the sleep lock so a worker about to sleep can't miss it
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		queued++;
+	}
+	wake.notify_one();
+}
+
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> lock(sleepLock);
+	done.wait(lock, [this]() { return pending == 0; });
+}
+
+bool ThreadPool::takeJob(unsigned worker, std::function<void()> &job) {
+	// newest from our own queue first, it's the most likely to still be in cache...
+	{
+		Queue &own = *queues[worker];
+		std::lock_guard<std::mutex> lock(own.lock);
+		if (!own.jobs.empty()) {
+			job = std::move(own.jobs.back());
+			own.jobs.pop_back();
+			queued--;
+			return true;
+		}
+	}
+
+	// ...then the oldest from anyone else's, starting with the next worker along
+	for (size_t i = 1; i < queues.size(); i++) {
+		Queue &other = *queues[(worker + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(other.lock);
+		if (!other.jobs.empty()) {
+			job = std::move(other.jobs.front());
+			other.jobs.pop_front();
+			queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::run(unsigned worker) {
+	for (;;) {
+		std::function<void()> job;
+		if (takeJob(worker, job)) {
+			job();
+
+			// the lock makes sure wait() is either checking or already asleep
+			if (--pending == 0) {
+				std::lock_guard<std::mutex> lock(sleepLock);
+				done.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepLock);
+		wake.wait(lock, [this]() { return stopping || queued > 0; });
+		if (stopping)
+			return;
+	}
+}
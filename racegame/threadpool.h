@@ -0,0 +1,52 @@
+#pragma once
+
+// work-stealing thread pool - every worker has its own queue and works from the back
+// of it, and a worker whose queue runs dry steals from the front of someone else's, so
+// uneven jobs stay spread over every core without all the threads fighting over one queue
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+	// starts the given number of workers, or one per hardware thread for 0
+	explicit ThreadPool(unsigned threads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	// queues a job - jobs are handed to the workers in turn, then stolen as they free up
+	void submit(std::function<void()> job);
+
+	// blocks until every job submitted so far has finished
+	void wait();
+
+	unsigned size() const { return (unsigned)workers.size(); }
+
+private:
+	struct Queue {
+		std::mutex lock;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;	// one per worker
+	std::vector<std::thread> workers;
+	unsigned nextQueue = 0;
+
+	// idle workers sleep on wake, wait() sleeps on done
+	std::mutex sleepLock;
+	std::condition_variable wake, done;
+	std::atomic<size_t> queued;		// jobs sitting in a queue
+	std::atomic<size_t> pending;	// jobs submitted and not yet finished
+	bool stopping = false;
+
+	bool takeJob(unsigned worker, std::function<void()> &job);
+	void run(unsigned worker);
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+// a sparse grid of cells over the plane - cells are grouped into square tiles, and only
+// the tiles something was stored in exist, found through a small open addressed hash
+// table. a long thin circuit then costs memory for its road rather than for its whole
+// bounding box, and cells nobody stored read as a fallback value
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include "geometry.h"
+
+// one entry in a TileMap's hash table
+struct TileSlot {
+	int32_t x, y;		// tile coordinates
+	uint32_t tile;		// index of the tile's cells, or emptyTile
+};
+
+const uint32_t emptyTile = 0xffffffff;
+
+template <typename T, int TileShift = 4> class TileMap {
+public:
+	static const int tileShift = TileShift;
+	static const int tileSize = 1 << tileShift;		// cells along each side of a tile
+	static const int tileCells = tileSize * tileSize;
+
+	// starts again with no tiles, and cells of the given size
+	void reset(float cellSize, const T &fallback) {
+		size = cellSize;
+		invCellSize = 1.0f / cellSize;
+		fallbackCell = fallback;
+		ownedSlots.clear();
+		ownedCells.clear();
+		ownedCoords.clear();
+		building.clear();
+		slotView = ArrayView<TileSlot>();
+		cellView = ArrayView<T>();
+		mask = 0;
+	}
+
+	// while building - the index of tile (tx, ty), which is added filled with the fallback
+	// if it isn't there yet
+	uint32_t addTile(int tx, int ty) {
+		uint64_t key = ((uint64_t)(uint32_t)tx << 32) | (uint32_t)ty;
+		std::unordered_map<uint64_t, uint32_t>::iterator found = building.find(key);
+		if (found != building.end())
+			return found->second;
+
+		uint32_t tile = (uint32_t)ownedCoords.size();
+		building[key] = tile;
+		ownedCoords.push_back({ tx, ty, tile });
+		ownedCells.resize(ownedCells.size() + tileCells, fallbackCell);
+		return tile;
+	}
+
+	// while building - the cells of a tile, row by row. only good until the next addTile()
+	T *tileCellsFor(uint32_t tile) { return &ownedCells[(size_t)tile * tileCells]; }
+	size_t tileCount() const { return ownedCoords.empty() ? cellView.size() / tileCells : ownedCoords.size(); }
+	void tileCoords(uint32_t tile, int &tx, int &ty) const { tx = ownedCoords[tile].x; ty = ownedCoords[tile].y; }
+
+	// the bottom left corner of a cell
+	point cellCorner(int cx, int cy) const { return { cx * size, cy * size }; }
+
+	// once every tile has been added, lays out the hash table that lookups go through
+	void finish() {
+		uint32_t slots = 16;
+		while (slots < ownedCoords.size() * 2)
+			slots *= 2;
+		mask = slots - 1;
+
+		TileSlot empty = { 0, 0, emptyTile };
+		ownedSlots.assign(slots, empty);
+		for (size_t i = 0; i < ownedCoords.size(); i++) {
+			uint32_t s = slot(ownedCoords[i].x, ownedCoords[i].y);
+			while (ownedSlots[s].tile != emptyTile)
+				s = (s + 1) & mask;
+			ownedSlots[s] = ownedCoords[i];
+		}
+
+		building.clear();
+		slotView = ownedSlots;
+		cellView = ownedCells;
+	}
+
+	// uses a table and cells that finish() made earlier and were stored elsewhere, such as
+	// in a compiled track file - nothing is copied, so the arrays have to outlive the map.
+	// the slot count has to be a power of two
+	bool attach(float cellSize, const T &fallback, ArrayView<TileSlot> slots, ArrayView<T> cells) {
+		if (cellSize <= 0 || slots.empty() || (slots.size() & (slots.size() - 1)) != 0 || cells.size() % tileCells != 0)
+			return false;
+
+		reset(cellSize, fallback);
+		mask = (uint32_t)slots.size() - 1;
+		slotView = slots;
+		cellView = cells;
+		return true;
+	}
+
+	// the cell a coordinate falls in - rounding down without calling floor, which isn't
+	// an instruction before sse4.1
+	int cellIndex(float v) const {
+		float scaled = v * invCellSize;
+		int truncated = (int)scaled;
+		return truncated - (scaled < truncated);
+	}
+
+	// the cell under a point, or the fallback where no tile was stored
+	const T &at(float x, float y) const { return cellAt(cellIndex(x), cellIndex(y)); }
+
+	const T &cellAt(int cx, int cy) const {
+		// tiles are found with an arithmetic shift, so negative cells round down too
+		const T *tile = findTile(cx >> tileShift, cy >> tileShift);
+		return tile ? tile[(cy & (tileSize - 1)) * tileSize + (cx & (tileSize - 1))] : fallbackCell;
+	}
+
+	// the cells of tile (tx, ty) row by row, or null if it wasn't stored
+	const T *findTile(int tx, int ty) const {
+		if (slotView.empty())
+			return nullptr;
+
+		uint32_t s = slot(tx, ty);
+		for (uint32_t probes = 0; probes <= mask; probes++, s = (s + 1) & mask) {
+			const TileSlot &entry = slotView[s];
+			if (entry.tile == emptyTile)
+				break;
+			if (entry.x == tx && entry.y == ty)
+				return &cellView[(size_t)entry.tile * tileCells];
+		}
+		return nullptr;
+	}
+
+	bool empty() const { return cellView.empty(); }
+
+	// what attach() needs to rebuild this map
+	float cell() const { return size; }
+	float inverseCell() const { return invCellSize; }
+	const T &fallback() const { return fallbackCell; }
+	ArrayView<TileSlot> slots() const { return slotView; }
+	ArrayView<T> storedCells() const { return cellView; }
+
+private:
+	float size = 1.0f;
+	float invCellSize = 1.0f;
+	T fallbackCell = T();
+	uint32_t mask = 0;
+
+	// point into the vectors below after finish(), or wherever attach() said - the table is
+	// always at most half full, so a lookup stops at an empty slot within a probe or two
+	ArrayView<TileSlot> slotView;
+	ArrayView<T> cellView;
+
+	std::vector<TileSlot> ownedSlots;
+	std::vector<T> ownedCells;
+	std::vector<TileSlot> ownedCoords;	// each tile's coordinates, in the order they were added
+	std::unordered_map<uint64_t, uint32_t> building;
+
+	uint32_t slot(int tx, int ty) const {
+		return ((uint32_t)tx * 73856093u ^ (uint32_t)ty * 19349663u) & mask;
+	}
+};
@@ -0,0 +1,134 @@
+#include "tournament.h"
+#include "simulation.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// each race runs for this long - long enough for a few laps each
+static const float raceSeconds = 120.0f;
+
+// the values tried for each setting, every combination of them is one configuration
+static const float maxSpeeds[] = { 0.012f, 0.014f, 0.016f };
+static const float rotRates[] = { 0.15f, 0.2f, 0.25f };
+static const float decelRates[] = { 0.0000045f, 0.000009f, 0.000018f };
+
+// everything raced with one configuration
+struct ConfigResult {
+	CarTuning tuning;
+	int races = 0;
+	int cars = 0;
+	int carsWithoutLap = 0;		// never finished a lap - usually stuck on a wall
+	std::vector<float> laps;
+};
+
+// nearest rank percentile of already sorted lap times
+static float percentile(const std::vector<float> &sorted, float p) {
+	size_t rank = (size_t)(p * sorted.size() + 0.999999f);
+	return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+int runTournament(int races, int carsPerRace, int threads, const std::string &trackPath) {
+	// one track, shared read-only by every race
+	Track sharedTrack;
+	std::string error;
+	if (!sharedTrack.load(trackPath, error)) {
+		std::cout << "couldn't load track: " << error << std::endl;
+		return 1;
+	}
+
+	std::vector<ConfigResult> configs;
+	for (float speed : maxSpeeds) {
+		for (float rotation : rotRates) {
+			for (float decel : decelRates) {
+				ConfigResult config;
+				config.tuning.maxSpeed = speed;
+				config.tuning.rotRate = rotation;
+				config.tuning.decelRate = decel;
+				configs.push_back(config);
+			}
+		}
+	}
+
+	// every race writes only its own slot, so the jobs share nothing but the track
+	struct RaceResult {
+		std::vector<LapRecord> laps;
+		int carsWithoutLap = 0;
+	};
+	std::vector<RaceResult> results(races);
+	const long ticks = (long)(raceSeconds / tickSeconds);
+
+	ThreadPool pool(threads);
+	auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < races; i++) {
+		pool.submit([&, i]() {
+			Race race;
+			race.tuning = configs[i % configs.size()].tuning;
+			initRace(race, sharedTrack, carsPerRace, false, (unsigned)i + 1, (uint64_t)ticks);
+
+			for (long tick = 0; tick < ticks; tick++)
+				stepRace(race);
+
+			results[i].laps = race.lapLog;
+			for (size_t car = 0; car < race.cars.size(); car++)
+				results[i].carsWithoutLap += race.laps.completed[car] == 0;
+		});
+	}
+	pool.wait();
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	for (int i = 0; i < races; i++) {
+		ConfigResult &config = configs[i % configs.size()];
+		config.races++;
+		config.cars += carsPerRace;
+		config.carsWithoutLap += results[i].carsWithoutLap;
+		for (size_t lap = 0; lap < results[i].laps.size(); lap++)
+			config.laps.push_back(results[i].laps[lap].seconds);
+	}
+
+	for (size_t i = 0; i < configs.size(); i++)
+		std::sort(configs[i].laps.begin(), configs[i].laps.end());
+
+	// fastest median first, configurations that never finished a lap last
+	std::sort(configs.begin(), configs.end(), [](const ConfigResult &a, const ConfigResult &b) {
+		if (a.laps.empty() || b.laps.empty())
+			return !a.laps.empty() && b.laps.empty();
+		return percentile(a.laps, 0.5f) < percentile(b.laps, 0.5f);
+	});
+
+	std::cout << "races       : " << races << " of " << raceSeconds << "s, " << carsPerRace << " cars each" << std::endl;
+	std::cout << "threads     : " << pool.size() << std::endl;
+	std::cout << "wall seconds: " << elapsed.count() << std::endl;
+	std::cout << "races/sec   : " << (elapsed.count() > 0 ? races / elapsed.count() : 0) << std::endl;
+	std::cout << "car ticks/s : " << (elapsed.count() > 0 ? (double)races * carsPerRace * ticks / elapsed.count() : 0) << std::endl;
+
+	std::cout << std::endl << std::setw(10) << "maxSpeed" << std::setw(9) << "rotRate" << std::setw(11) << "decelRate"
+		<< std::setw(7) << "races" << std::setw(7) << "laps" << std::setw(9) << "no lap"
+		<< std::setw(9) << "best" << std::setw(9) << "p10" << std::setw(9) << "p50" << std::setw(9) << "p90" << std::endl;
+
+	for (size_t i = 0; i < configs.size(); i++) {
+		const ConfigResult &config = configs[i];
+		std::cout << std::setw(10) << config.tuning.maxSpeed << std::setw(9) << config.tuning.rotRate
+			<< std::setw(11) << config.tuning.decelRate << std::setw(7) << config.races
+			<< std::setw(7) << config.laps.size() << std::setw(9) << config.carsWithoutLap;
+
+		if (config.laps.empty()) {
+			std::cout << std::endl;
+			continue;
+		}
+
+		std::cout << std::fixed << std::setprecision(2)
+			<< std::setw(9) << config.laps.front()
+			<< std::setw(9) << percentile(config.laps, 0.1f)
+			<< std::setw(9) << percentile(config.laps, 0.5f)
+			<< std::setw(9) << percentile(config.laps, 0.9f) << std::endl;
+		std::cout.unsetf(std::ios::fixed);
+		std::cout << std::setprecision(6);
+	}
+
+	return 0;
+}
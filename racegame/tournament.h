@@ -0,0 +1,12 @@
+#pragma once
+
+// overnight tuning - thousands of cpu-only races run side by side, each with different
+// car handling, to see which settings lap fastest
+
+#include <string>
+
+// races every combination of a few maxSpeed, rotRate and decelRate values, the given
+// number of races in all with carsPerRace cpu cars each, spread over a work-stealing pool
+// of the given number of threads (0 for one per core). prints the lap time distribution
+// each combination produced, fastest first - returns the process exit code
+int runTournament(int races, int carsPerRace, int threads, const std::string &trackPath);
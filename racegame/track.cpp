@@ -0,0 +1,340 @@
+#include "track.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+
+// compiled layout: this header, then each array at its offset, 16 byte aligned. values
+// are stored in the machine's own byte order, as the file is mapped rather than read
+struct TrackHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t wallCount, startCount, sectorCount, waypointCount;
+	float cellSize;
+	uint32_t bucketCount, itemCount;
+	uint32_t reserved;
+	uint64_t wallOffset, startOffset, sectorOffset, waypointOffset, bucketOffset, itemOffset;
+	float fieldCellSize;
+	uint32_t fieldSlotCount, fieldCellCount;
+	uint32_t reserved2;
+	uint64_t fieldSlotOffset, fieldCellOffset;
+	float distanceCellSize, distanceBand;
+	uint32_t distanceSlotCount, distanceSampleCount;
+	uint64_t distanceSlotOffset, distanceSampleOffset;
+};
+
+static const char trackMagic[4] = { 'R', 'G', 'T', 'R' };
+static const uint32_t trackVersion = 4;
+
+std::string compiledTrackPath(const std::string &sourcePath) {
+	const std::string extension = ".track";
+	if (sourcePath.size() > extension.size() && sourcePath.compare(sourcePath.size() - extension.size(), extension.size(), extension) == 0)
+		return sourcePath.substr(0, sourcePath.size() - extension.size()) + ".trk";
+	return sourcePath + ".trk";
+}
+
+// modification time, or -1 if the file isn't there
+static long long modifiedTime(const std::string &path) {
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return -1;
+	return (long long)info.st_mtime;
+}
+
+bool Track::load(const std::string &path, std::string &error) {
+	// a compiled file can be given directly
+	char magic[4] = {};
+	FILE *in = fopen(path.c_str(), "rb");
+	if (!in) {
+		error = "can't open " + path;
+		return false;
+	}
+	size_t read = fread(magic, 1, sizeof(magic), in);
+	fclose(in);
+	if (read == sizeof(magic) && memcmp(magic, trackMagic, sizeof(magic)) == 0)
+		return loadCompiled(path, error);
+
+	// otherwise it's the text, and the compiled copy is used unless it's older
+	std::string compiled = compiledTrackPath(path);
+	std::string ignored;
+	if (modifiedTime(compiled) >= modifiedTime(path) && loadCompiled(compiled, ignored))
+		return true;
+
+	if (!compile(path, error))
+		return false;
+
+	// if this can't be written the track still loads, it just compiles again next time
+	save(compiled);
+	return true;
+}
+
+bool Track::compile(const std::string &sourcePath, std::string &error) {
+	std::ifstream source(sourcePath.c_str());
+	if (!source) {
+		error = "can't open " + sourcePath;
+		return false;
+	}
+
+	// read into these, so a bad file leaves the loaded track alone
+	TrackLayout layout;
+	std::vector<edge> &walls = layout.walls, &starts = layout.starts, &sectors = layout.sectors;
+	std::vector<point> &waypoints = layout.waypoints;
+	float &cellSize = layout.cellSize;
+
+	// one item per line: a keyword then its numbers, # starts a comment
+	std::string line;
+	for (int lineNumber = 1; std::getline(source, line); lineNumber++) {
+		size_t comment = line.find('#');
+		if (comment != std::string::npos)
+			line.erase(comment);
+
+		std::istringstream fields(line);
+		std::string keyword;
+		if (!(fields >> keyword))
+			continue;
+
+		bool valid;
+		if (keyword == "wall" || keyword == "start" || keyword == "sector") {
+			edge e;
+			valid = (bool)(fields >> e.p1.x >> e.p1.y >> e.p2.x >> e.p2.y);
+			std::vector<edge> &edges = keyword == "wall" ? walls : keyword == "start" ? starts : sectors;
+			edges.push_back(e);
+		}
+		else if (keyword == "waypoint") {
+			point p;
+			valid = (bool)(fields >> p.x >> p.y);
+			waypoints.push_back(p);
+		}
+		else if (keyword == "grid") {
+			valid = (bool)(fields >> cellSize) && cellSize > 0;
+		}
+		else {
+			error = sourcePath + ":" + std::to_string(lineNumber) + ": unknown item '" + keyword + "'";
+			return false;
+		}
+
+		std::string extra;
+		if (!valid || fields >> extra) {
+			error = sourcePath + ":" + std::to_string(lineNumber) + ": bad " + keyword;
+			return false;
+		}
+	}
+
+	if (!build(layout, error)) {
+		error = sourcePath + ": " + error;
+		return false;
+	}
+	return true;
+}
+
+bool Track::build(TrackLayout &layout, std::string &error) {
+	// the lap timer and the cpu cars can't do without these - the waypoints are the
+	// centreline laps are measured along, so they have to go round
+	if (layout.starts.empty() || layout.waypoints.size() < 3) {
+		error = "needs at least one start line and three waypoints";
+		return false;
+	}
+
+	file.close();
+	ownedWalls.swap(layout.walls);
+	ownedStarts.swap(layout.starts);
+	ownedSectors.swap(layout.sectors);
+	ownedWaypoints.swap(layout.waypoints);
+
+	wallView = ownedWalls;
+	startView = ownedStarts;
+	sectorView = ownedSectors;
+	waypointView = ownedWaypoints;
+	wallGrid.build(wallView, layout.cellSize);
+	steeringField.build(waypointView, wallGrid);
+	distanceField.build(wallView);
+	centre.build(waypointView, startView[0], sectorView);
+	return true;
+}
+
+bool Track::loadCompiled(const std::string &path, std::string &error) {
+	MappedFile mapped;
+	if (!mapped.open(path.c_str())) {
+		error = "can't open " + path;
+		return false;
+	}
+
+	const TrackHeader *header = (const TrackHeader *)mapped.data();
+	if (mapped.size() < sizeof(TrackHeader) || memcmp(header->magic, trackMagic, 4) != 0 || header->version != trackVersion) {
+		error = path + " isn't a compiled track, or is from another version";
+		return false;
+	}
+
+	// every array has to lie inside the file - the only checking done, so loading
+	// doesn't depend on the size of the track
+	auto fits = [&](uint64_t offset, uint64_t count, size_t size) {
+		return offset <= mapped.size() && count <= (mapped.size() - offset) / size;
+	};
+	if (!fits(header->wallOffset, header->wallCount, sizeof(edge)) ||
+		!fits(header->startOffset, header->startCount, sizeof(edge)) ||
+		!fits(header->sectorOffset, header->sectorCount, sizeof(edge)) ||
+		!fits(header->waypointOffset, header->waypointCount, sizeof(point)) ||
+		!fits(header->bucketOffset, (uint64_t)header->bucketCount + 1, sizeof(uint32_t)) ||
+		!fits(header->itemOffset, header->itemCount, sizeof(edge)) ||
+		!fits(header->fieldSlotOffset, header->fieldSlotCount, sizeof(TileSlot)) ||
+		!fits(header->fieldCellOffset, header->fieldCellCount, sizeof(SteeringCell)) ||
+		!fits(header->distanceSlotOffset, header->distanceSlotCount, sizeof(TileSlot)) ||
+		!fits(header->distanceSampleOffset, header->distanceSampleCount, sizeof(float)) ||
+		header->startCount == 0 || header->waypointCount < 3) {
+		error = path + " is truncated or corrupt";
+		return false;
+	}
+
+	const unsigned char *base = mapped.data();
+	TrackGrid grid;
+	if (!grid.attach(header->cellSize, header->bucketCount, (const uint32_t *)(base + header->bucketOffset),
+		(const edge *)(base + header->itemOffset), header->itemCount)) {
+		error = path + " has a corrupt collision grid";
+		return false;
+	}
+
+	SteeringField field;
+	ArrayView<TileSlot> fieldSlots((const TileSlot *)(base + header->fieldSlotOffset), header->fieldSlotCount);
+	ArrayView<SteeringCell> fieldCells((const SteeringCell *)(base + header->fieldCellOffset), header->fieldCellCount);
+	if (!field.attach(header->fieldCellSize, fieldSlots, fieldCells)) {
+		error = path + " has a corrupt steering field";
+		return false;
+	}
+
+	DistanceField distances;
+	ArrayView<TileSlot> distanceSlots((const TileSlot *)(base + header->distanceSlotOffset), header->distanceSlotCount);
+	ArrayView<float> distanceSamples((const float *)(base + header->distanceSampleOffset), header->distanceSampleCount);
+	if (!distances.attach(header->distanceCellSize, header->distanceBand, distanceSlots, distanceSamples)) {
+		error = path + " has a corrupt distance field";
+		return false;
+	}
+
+	// only now is the old track replaced
+	file.close();
+	ownedWalls.clear();
+	ownedStarts.clear();
+	ownedSectors.clear();
+	ownedWaypoints.clear();
+
+	wallView = EdgeSpan((const edge *)(base + header->wallOffset), header->wallCount);
+	startView = EdgeSpan((const edge *)(base + header->startOffset), header->startCount);
+	sectorView = EdgeSpan((const edge *)(base + header->sectorOffset), header->sectorCount);
+	waypointView = ArrayView<point>((const point *)(base + header->waypointOffset), header->waypointCount);
+	wallGrid.attach(header->cellSize, header->bucketCount, (const uint32_t *)(base + header->bucketOffset),
+		(const edge *)(base + header->itemOffset), header->itemCount);
+	steeringField.attach(header->fieldCellSize, fieldSlots, fieldCells);
+	distanceField.attach(header->distanceCellSize, header->distanceBand, distanceSlots, distanceSamples);
+	centre.build(waypointView, startView[0], sectorView);
+
+	// the views stay valid - handing the mapping over doesn't move the memory
+	file.swap(mapped);
+	return true;
+}
+
+bool Track::save(const std::string &path) const {
+	// lay out the arrays first, then write them in order with padding between
+	TrackHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, trackMagic, 4);
+	header.version = trackVersion;
+	header.wallCount = (uint32_t)wallView.size();
+	header.startCount = (uint32_t)startView.size();
+	header.sectorCount = (uint32_t)sectorView.size();
+	header.waypointCount = (uint32_t)waypointView.size();
+	header.cellSize = wallGrid.cell();
+	header.bucketCount = wallGrid.bucketCount();
+	header.itemCount = (uint32_t)wallGrid.storedItems().size();
+	header.fieldCellSize = steeringField.cell();
+	header.fieldSlotCount = (uint32_t)steeringField.slots().size();
+	header.fieldCellCount = (uint32_t)steeringField.storedCells().size();
+	header.distanceCellSize = distanceField.cell();
+	header.distanceBand = distanceField.band();
+	header.distanceSlotCount = (uint32_t)distanceField.slots().size();
+	header.distanceSampleCount = (uint32_t)distanceField.storedSamples().size();
+
+	struct Block {
+		const void *data;
+		size_t bytes;
+		uint64_t *offset;
+	};
+	const Block blocks[] = {
+		{ wallView.data, wallView.size() * sizeof(edge), &header.wallOffset },
+		{ startView.data, startView.size() * sizeof(edge), &header.startOffset },
+		{ sectorView.data, sectorView.size() * sizeof(edge), &header.sectorOffset },
+		{ waypointView.data, waypointView.size() * sizeof(point), &header.waypointOffset },
+		{ wallGrid.bucketStarts().data, wallGrid.bucketStarts().size() * sizeof(uint32_t), &header.bucketOffset },
+		{ wallGrid.storedItems().data, wallGrid.storedItems().size() * sizeof(edge), &header.itemOffset },
+		{ steeringField.slots().data, steeringField.slots().size() * sizeof(TileSlot), &header.fieldSlotOffset },
+		{ steeringField.storedCells().data, steeringField.storedCells().size() * sizeof(SteeringCell), &header.fieldCellOffset },
+		{ distanceField.slots().data, distanceField.slots().size() * sizeof(TileSlot), &header.distanceSlotOffset },
+		{ distanceField.storedSamples().data, distanceField.storedSamples().size() * sizeof(float), &header.distanceSampleOffset },
+	};
+	const size_t blockCount = sizeof(blocks) / sizeof(blocks[0]);
+
+	uint64_t offset = sizeof(TrackHeader);
+	for (size_t i = 0; i < blockCount; i++) {
+		offset = (offset + 15) & ~(uint64_t)15;
+		*blocks[i].offset = offset;
+		offset += blocks[i].bytes;
+	}
+
+	FILE *out = fopen(path.c_str(), "wb");
+	if (!out)
+		return false;
+
+	bool written = fwrite(&header, sizeof(header), 1, out) == 1;
+	uint64_t position = sizeof(TrackHeader);
+	const char padding[16] = {};
+	for (size_t i = 0; i < blockCount && written; i++) {
+		written = fwrite(padding, 1, (size_t)(*blocks[i].offset - position), out) == *blocks[i].offset - position;
+		if (blocks[i].bytes > 0)
+			written = written && fwrite(blocks[i].data, blocks[i].bytes, 1, out) == 1;
+		position = *blocks[i].offset + blocks[i].bytes;
+	}
+
+	written = fclose(out) == 0 && written;
+	if (!written)
+		remove(path.c_str());
+	return written;
+}
+
+int compileTrackFile(const std::string &sourcePath, const std::string &outputPath) {
+	Track track;
+	std::string error;
+	if (!track.compile(sourcePath, error)) {
+		std::cout << error << std::endl;
+		return 1;
+	}
+
+	if (!track.save(outputPath)) {
+		std::cout << "couldn't write " << outputPath << std::endl;
+		return 1;
+	}
+
+	std::cout << outputPath << ": " << track.walls().size() << " walls, " << track.startLines().size() << " start lines, "
+		<< track.sectorLines().size() << " sectors, " << track.waypoints().size() << " waypoints, "
+		<< track.grid().storedEdges() << " edges in the grid, " << track.steering().storedCells().size()
+		<< " steering cells, " << track.wallDistance().storedSamples().size() << " distance samples" << std::endl;
+	return 0;
+}
+
+// fnv-1a
+static uint32_t hashBytes(uint32_t hash, const void *data, size_t bytes) {
+	const uint8_t *b = (const uint8_t *)data;
+	for (size_t i = 0; i < bytes; i++)
+		hash = (hash ^ b[i]) * 16777619u;
+	return hash;
+}
+
+uint32_t hashTrack(const Track &track) {
+	uint32_t hash = 2166136261u;
+	hash = hashBytes(hash, track.walls().data, track.walls().size() * sizeof(edge));
+	hash = hashBytes(hash, track.startLines().data, track.startLines().size() * sizeof(edge));
+	hash = hashBytes(hash, track.sectorLines().data, track.sectorLines().size() * sizeof(edge));
+	hash = hashBytes(hash, track.waypoints().data, track.waypoints().size() * sizeof(point));
+	hash = hashBytes(hash, track.wallDistance().storedSamples().data, track.wallDistance().storedSamples().size() * sizeof(float));
+	hash = hashBytes(hash, track.steering().storedCells().data, track.steering().storedCells().size() * sizeof(SteeringCell));
+	return hash;
+}
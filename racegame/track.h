@@ -0,0 +1,80 @@
+#pragma once
+
+// a circuit - walls, timing lines, waypoints, the collision grid and distance field over
+// the walls and the steering field cpu cars drive by. tracks are written as text (see
+// tracks/default.track) and compiled into a binary file that is mapped straight in and
+// used where it lies, so loading costs the same however big the circuit is
+
+#include <string>
+#include <vector>
+#include "geometry.h"
+#include "collision.h"
+#include "mappedfile.h"
+#include "steering.h"
+#include "distancefield.h"
+#include "centreline.h"
+
+// everything a track is made from, before the grid and fields are built over it - what
+// a text track holds, and what the generator makes
+struct TrackLayout {
+	std::vector<edge> walls, starts, sectors;
+	std::vector<point> waypoints;
+	float cellSize = 12.0f;		// collision grid cell - about a road wide, so sensor rays cross few
+};
+
+class Track {
+public:
+	Track() {}
+	Track(const Track &) = delete;
+	Track &operator=(const Track &) = delete;
+
+	// loads a text track or a compiled one, whichever the file holds - a text track is
+	// loaded from its compiled copy alongside (.trk in place of .track) when that is up to
+	// date, and compiled and saved there when not. on failure error says why
+	bool load(const std::string &path, std::string &error);
+
+	// reads a text track and builds the grid and fields, without touching any compiled copy
+	bool compile(const std::string &sourcePath, std::string &error);
+
+	// builds the grid and fields over a layout made in memory, taking its arrays
+	bool build(TrackLayout &layout, std::string &error);
+
+	// maps a compiled track file
+	bool loadCompiled(const std::string &path, std::string &error);
+
+	// writes the compiled form of whatever is loaded
+	bool save(const std::string &path) const;
+
+	EdgeSpan walls() const { return wallView; }
+	EdgeSpan startLines() const { return startView; }		// the first is the one laps are timed on
+	EdgeSpan sectorLines() const { return sectorView; }
+	ArrayView<point> waypoints() const { return waypointView; }
+	const TrackGrid &grid() const { return wallGrid; }
+	const SteeringField &steering() const { return steeringField; }
+	const DistanceField &wallDistance() const { return distanceField; }
+	const Centreline &centreline() const { return centre; }
+
+private:
+	// views into the mapped file, or into the vectors after compile()
+	EdgeSpan wallView, startView, sectorView;
+	ArrayView<point> waypointView;
+	TrackGrid wallGrid;
+	SteeringField steeringField;
+	DistanceField distanceField;
+	Centreline centre;
+
+	MappedFile file;
+	std::vector<edge> ownedWalls, ownedStarts, ownedSectors;
+	std::vector<point> ownedWaypoints;
+};
+
+// a hash of everything a race reads from a track - walls, start and sector lines, the
+// waypoints laps are timed along, the distance field and the ai's steering - so files made
+// on a circuit - control logs, ghosts - can't be used on one that has changed since
+uint32_t hashTrack(const Track &track);
+
+// where a text track's compiled copy goes
+std::string compiledTrackPath(const std::string &sourcePath);
+
+// --compile-track: compiles a text track into the given file, returns the process exit code
+int compileTrackFile(const std::string &sourcePath, const std::string &outputPath);
@@ -0,0 +1,200 @@
+#include "trackgen.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+static const double pi = 3.14159265358979;
+static const double halfWidth = 6;		// centre of the road to each wall, as on the default track
+static const double tightestBend = 9;	// smallest radius the centre of the road may turn on
+
+// one of the sine waves the loop's radius is wobbled by
+struct Wave {
+	int cycles;			// times round the loop
+	double amplitude;	// in world units
+	double phase;
+};
+
+static double random01(unsigned &state) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (state & 0xffffff) / (double)0xffffff;
+}
+
+// the centre of the road, as a radius at an angle round the loop. the waves fade out
+// over the last and first forty or so units of the lap, so the road runs straight up
+// through the start line
+static double radiusAt(double angle, double radius, const std::vector<Wave> &waves, double scale) {
+	double fromStart = std::min(angle, 2 * pi - angle) / std::min(0.5, 40 / radius);
+	double fade = 1 - exp(-fromStart * fromStart);
+	double wobble = 0;
+	for (size_t i = 0; i < waves.size(); i++)
+		wobble += waves[i].amplitude * sin(waves[i].cycles * angle + waves[i].phase);
+	return radius + scale * fade * wobble;
+}
+
+// a few long waves give the circuit its shape, and shorter ones a few hundred units
+// long put corners into it once it's big enough to have room for them - each sized so
+// that on its own it bends no tighter than a chosen radius
+static std::vector<Wave> pickWaves(unsigned &state, double radius) {
+	std::vector<Wave> waves;
+	for (int cycles = 2; cycles <= 5; cycles++)
+		waves.push_back({ cycles, radius * 0.12 * random01(state) / (cycles - 1), 2 * pi * random01(state) });
+
+	for (int i = 0; i < 6; i++) {
+		double wavelength = 80 + 220 * random01(state);
+		double bend = 30 + 60 * random01(state);
+		double phase = 2 * pi * random01(state);
+		int cycles = (int)(2 * pi * radius / wavelength + 0.5);
+		if (cycles > 5)
+			waves.push_back({ cycles, wavelength * wavelength / (4 * pi * pi * bend), phase });
+	}
+
+	// and never so much between them that the inside of the loop closes up
+	double total = 0;
+	for (size_t i = 0; i < waves.size(); i++)
+		total += waves[i].amplitude;
+	if (total > radius * 0.35)
+		for (size_t i = 0; i < waves.size(); i++)
+			waves[i].amplitude *= radius * 0.35 / total;
+	return waves;
+}
+
+// the walls either side of a run of centre points, joined into two closed loops
+static void buildWalls(const std::vector<point> &centre, std::vector<point> &outer, std::vector<point> &inner) {
+	int n = (int)centre.size();
+	outer.resize(n);
+	inner.resize(n);
+	for (int i = 0; i < n; i++) {
+		const point &before = centre[(i + n - 1) % n], &after = centre[(i + 1) % n];
+		float dx = after.x - before.x, dy = after.y - before.y;
+		float length = sqrt(dx * dx + dy * dy);
+		float nx = dy / length, ny = -dx / length;		// out from the middle of the loop
+		outer[i] = { centre[i].x + nx * (float)halfWidth, centre[i].y + ny * (float)halfWidth };
+		inner[i] = { centre[i].x - nx * (float)halfWidth, centre[i].y - ny * (float)halfWidth };
+	}
+}
+
+// most of the way from one wall to the other, leaving the ends clear of the walls they start on
+static edge across(const point &from, const point &to) {
+	float dx = (to.x - from.x) * 0.05f, dy = (to.y - from.y) * 0.05f;
+	return { { from.x + dx, from.y + dy }, { to.x - dx, to.y - dy } };
+}
+
+// the road can be driven all the way round - the centre never turns tighter than
+// tightestBend, and nothing crosses it from wall to wall, whether one of its own walls
+// folding over or another part of the circuit wandering too close
+static bool roadIsClear(const std::vector<point> &centre, const std::vector<point> &outer, const std::vector<point> &inner, const TrackGrid &walls) {
+	int n = (int)centre.size();
+	for (int i = 0; i < n; i++) {
+		const point &a = centre[(i + n - 1) % n], &b = centre[i], &c = centre[(i + 1) % n];
+		float ax = b.x - a.x, ay = b.y - a.y, bx = c.x - b.x, by = c.y - b.y;
+		float turn = fabs(atan2(ax * by - ay * bx, ax * bx + ay * by));
+		float run = (sqrt(ax * ax + ay * ay) + sqrt(bx * bx + by * by)) / 2;
+		if (turn * tightestBend > run)
+			return false;
+
+		// across the road at each point and halfway to the next, stopping just short of the
+		// walls - any wall in between is one that shouldn't be there
+		const point &o = outer[i], &in = inner[i], &o2 = outer[(i + 1) % n], &in2 = inner[(i + 1) % n];
+		point halfOut = { (o.x + o2.x) / 2, (o.y + o2.y) / 2 }, halfIn = { (in.x + in2.x) / 2, (in.y + in2.y) / 2 };
+		edge probes[2] = { across(in, o), across(halfIn, halfOut) };
+		if (walls.isColliding(EdgeSpan(probes, 2)))
+			return false;
+	}
+	return true;
+}
+
+TrackLayout generateTrack(unsigned seed, int segments) {
+	// xorshift sticks at zero
+	unsigned state = seed * 2654435761u + 1;
+	for (int i = 0; i < 4; i++)
+		random01(state);
+
+	int perWall = std::max(segments / 2, 16);
+	double radius = std::max(perWall * 2 / (2 * pi), 24.0);
+	std::vector<Wave> waves = pickWaves(state, radius);
+
+	// any circuit that can't be driven is tried again with the waves turned down - down
+	// to nothing, which leaves a plain ring
+	TrackLayout layout;
+	std::vector<point> centre(perWall), outer, inner;
+	for (double scale = 1; ; scale = scale > 0.01 ? scale * 0.75 : 0) {
+		for (int i = 0; i < perWall; i++) {
+			double angle = 2 * pi * i / perWall;
+			double r = radiusAt(angle, radius, waves, scale);
+
+			// moved so the start of the loop is at the origin
+			centre[i] = { (float)(r * cos(angle) - radius), (float)(r * sin(angle)) };
+		}
+		buildWalls(centre, outer, inner);
+
+		layout.walls.clear();
+		for (int i = 0; i < perWall; i++)
+			layout.walls.push_back({ outer[i], outer[(i + 1) % perWall] });
+		for (int i = 0; i < perWall; i++)
+			layout.walls.push_back({ inner[i], inner[(i + 1) % perWall] });
+
+		TrackGrid grid;
+		grid.build(layout.walls, layout.cellSize);
+		if (scale == 0 || roadIsClear(centre, outer, inner, grid))
+			break;
+	}
+
+	// across the road just past the first centre point, a little ahead of the grid's front
+	// row as on the default track
+	layout.starts.push_back({ { (float)-halfWidth, 0.6f }, { (float)halfWidth, 0.6f } });
+	for (int third = 1; third <= 2; third++) {
+		int i = perWall * third / 3;
+		layout.sectors.push_back({ inner[i], outer[i] });
+	}
+
+	// a waypoint about every ten units of road, and never fewer than eight
+	double run = 0;
+	for (int i = 0; i < perWall; i++) {
+		const point &a = centre[i], &b = centre[(i + 1) % perWall];
+		run += sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+	}
+	int stride = std::max(1, std::min((int)(10 / (run / perWall) + 0.5), perWall / 8));
+	for (int i = 0; i + stride / 2 < perWall; i += stride)
+		layout.waypoints.push_back(centre[i]);
+	return layout;
+}
+
+bool writeTrack(const std::string &path, const TrackLayout &layout) {
+	std::ofstream out(path.c_str());
+	out << std::setprecision(9);
+	out << "grid " << layout.cellSize << "\n";
+	for (size_t i = 0; i < layout.walls.size(); i++)
+		out << "wall " << layout.walls[i].p1.x << " " << layout.walls[i].p1.y << " " << layout.walls[i].p2.x << " " << layout.walls[i].p2.y << "\n";
+	for (size_t i = 0; i < layout.starts.size(); i++)
+		out << "start " << layout.starts[i].p1.x << " " << layout.starts[i].p1.y << " " << layout.starts[i].p2.x << " " << layout.starts[i].p2.y << "\n";
+	for (size_t i = 0; i < layout.sectors.size(); i++)
+		out << "sector " << layout.sectors[i].p1.x << " " << layout.sectors[i].p1.y << " " << layout.sectors[i].p2.x << " " << layout.sectors[i].p2.y << "\n";
+	for (size_t i = 0; i < layout.waypoints.size(); i++)
+		out << "waypoint " << layout.waypoints[i].x << " " << layout.waypoints[i].y << "\n";
+	out.close();
+	return !out.fail();
+}
+
+int generateTrackFile(unsigned seed, int segments, const std::string &path) {
+	TrackLayout layout = generateTrack(seed, segments);
+	size_t walls = layout.walls.size(), waypoints = layout.waypoints.size();
+	if (!writeTrack(path, layout)) {
+		std::cout << "can't write " << path << std::endl;
+		return 1;
+	}
+
+	// built once here, so a circuit that won't load is found now rather than at the start of a race
+	Track generated;
+	std::string error;
+	if (!generated.build(layout, error)) {
+		std::cout << "generated track doesn't build: " << error << std::endl;
+		return 1;
+	}
+	std::cout << "wrote seed " << seed << " to " << path << ", " << walls << " walls, " << waypoints << " waypoints, lap of "
+		<< generated.centreline().length() << " units" << std::endl;
+	return 0;
+}
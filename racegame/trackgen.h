@@ -0,0 +1,22 @@
+#pragma once
+
+// closed circuits made from a seed - a loop of road 12 units wide wound round a centre,
+// its radius wobbled by a handful of sine waves, with the start line, two sector lines
+// and waypoints laid along it the way tracks/default.track has them. the same seed and
+// segment count always give the same circuit, so a benchmark can sweep the size of the
+// track and be run again on another day against exactly the same walls
+
+#include <string>
+#include "track.h"
+
+// a circuit with about the given number of wall segments, split between the outer and
+// inner walls, each about two units long once the track is big enough - so like the ring
+// the benchmarks use, more segments make a longer lap rather than a finer one. the start
+// line is at the origin across a straight heading up +y, with the grid behind it
+TrackLayout generateTrack(unsigned seed, int segments);
+
+// writes a layout as a text track, which compiles back to the same walls
+bool writeTrack(const std::string &path, const TrackLayout &layout);
+
+// --generate-track: writes a generated circuit as a text track, returns the process exit code
+int generateTrackFile(unsigned seed, int segments, const std::string &path);
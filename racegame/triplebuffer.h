@@ -0,0 +1,37 @@
+#pragma once
+
+// hands values from one thread to another without either waiting - the writer fills a
+// slot of its own and publishes it, the reader takes whichever slot was published last.
+// three slots mean there is always one for each side plus the newest in between, so
+// a slow reader just skips values and a slow writer just leaves the reader redrawing
+// the last one
+
+#include <atomic>
+
+template <typename T> class TripleBuffer {
+public:
+	// the slot the writer fills next - nobody else touches it until publish()
+	T &back() { return slots[backIndex]; }
+
+	// makes the back slot the newest, and takes the one it replaces to fill next
+	void publish() {
+		backIndex = middle.exchange(backIndex | fresh, std::memory_order_acq_rel) & indexMask;
+	}
+
+	// the newest slot published, swapped in if there's been one since the last call - it
+	// stays the reader's own until the next call
+	const T &front() {
+		if (middle.load(std::memory_order_relaxed) & fresh)
+			frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+		return slots[frontIndex];
+	}
+
+private:
+	static const int indexMask = 3;
+	static const int fresh = 4;		// set in middle when the writer has published since the reader last took it
+
+	T slots[3];
+	int backIndex = 0;		// only the writer uses this
+	int frontIndex = 1;		// only the reader uses this
+	std::atomic<int> middle{ 2 };
+};
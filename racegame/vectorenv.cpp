@@ -0,0 +1,127 @@
+#include "vectorenv.h"
+#include "raycast.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+
+VectorEnv::VectorEnv(const Track &raceTrack, const VectorEnvConfig &envConfig) : track(raceTrack), config(envConfig) {
+	config.envs = std::max(config.envs, 1);
+	config.rays = std::max(config.rays, 0);
+	config.ticksPerStep = std::max(config.ticksPerStep, 1);
+
+	races.resize(config.envs);
+	steps.assign(config.envs, 0);
+	episodes.assign(config.envs, 0);
+	covered.assign(config.envs, 0.0f);
+	observationBuffer.assign((size_t)config.envs * observationSize(), 0.0f);
+	rewardBuffer.assign(config.envs, 0.0f);
+	terminatedBuffer.assign(config.envs, 0);
+	truncatedBuffer.assign(config.envs, 0);
+
+	// spread evenly from the leftmost round to the rightmost, or straight ahead for one
+	for (int i = 0; i < config.rays; i++) {
+		float degrees = config.rays > 1 ? config.raySpread * (0.5f - (float)i / (config.rays - 1)) : 0.0f;
+		rayDirections.push_back({ -sinf(degrees * piOver180), cosf(degrees * piOver180) });
+	}
+
+	// a few batches a worker, so one slow environment doesn't hold the rest up
+	if (config.threads != 1) {
+		pool.reset(new ThreadPool(config.threads));
+		batches = std::min(config.envs, (int)pool->size() * 4);
+	}
+	reset();
+}
+
+VectorEnv::~VectorEnv() {
+}
+
+template <typename Body> void VectorEnv::forEachEnv(Body body) {
+	if (!pool) {
+		for (int env = 0; env < config.envs; env++)
+			body(env);
+		return;
+	}
+
+	for (int batch = 0; batch < batches; batch++) {
+		pool->submit([this, batch, &body]() {
+			int first = config.envs * batch / batches, last = config.envs * (batch + 1) / batches;
+			for (int env = first; env < last; env++)
+				body(env);
+		});
+	}
+	pool->wait();
+}
+
+void VectorEnv::reset() {
+	forEachEnv([this](int env) {
+		resetEnv(env);
+		rewardBuffer[env] = 0.0f;
+		terminatedBuffer[env] = 0;
+		truncatedBuffer[env] = 0;
+		observe(env);
+	});
+	totalSteps = 0;
+}
+
+void VectorEnv::step(const unsigned char *actions) {
+	forEachEnv([this, actions](int env) { stepEnv(env, actions[env]); });
+	totalSteps += config.envs;
+}
+
+// the agent's car is the player's slot on the grid, and no two episodes anywhere share a seed
+void VectorEnv::resetEnv(int env) {
+	unsigned seed = config.seed + (unsigned)(episodes[env] * config.envs + env);
+	initRace(races[env], track, config.cpuCars, true, seed != 0 ? seed : 1, (uint64_t)config.maxSteps * config.ticksPerStep);
+	episodes[env]++;
+	steps[env] = 0;
+	covered[env] = coveredDistance(env);
+}
+
+void VectorEnv::stepEnv(int env, unsigned char action) {
+	Race &race = races[env];
+	for (int tick = 0; tick < config.ticksPerStep; tick++) {
+		race.cars.controls[playerCar] = action;
+		stepRace(race);
+	}
+	steps[env]++;
+
+	float now = coveredDistance(env);
+	rewardBuffer[env] = now - covered[env];
+	covered[env] = now;
+	terminatedBuffer[env] = race.laps.completed[playerCar] >= config.laps;
+	truncatedBuffer[env] = !terminatedBuffer[env] && steps[env] >= config.maxSteps;
+	if (terminatedBuffer[env] || truncatedBuffer[env])
+		resetEnv(env);
+	observe(env);
+}
+
+// how far the agent has come since the grid - the lap distance runs up to the lap length
+// and back to 0 as each lap is finished, so the laps are added back in
+float VectorEnv::coveredDistance(int env) const {
+	const LapTimers &laps = races[env].laps;
+	return laps.completed[playerCar] * track.centreline().length() + laps.distance[playerCar];
+}
+
+void VectorEnv::observe(int env) {
+	const Race &race = races[env];
+	const CarPool &cars = race.cars;
+	float *out = &observationBuffer[(size_t)env * observationSize()];
+
+	float x = cars.pos_x[playerCar], y = cars.pos_y[playerCar];
+	float vx = cars.vel_x[playerCar], vy = cars.vel_y[playerCar];
+	out[OBS_X] = x;
+	out[OBS_Y] = y;
+	out[OBS_HEADING_X] = vx;
+	out[OBS_HEADING_Y] = vy;
+	out[OBS_SPEED] = cars.speed[playerCar] / race.tuning.maxSpeed;
+
+	// the end of the centreline segment the car is on, turned into the car's frame - left is
+	// the heading turned a quarter anticlockwise
+	point next = track.centreline().segmentEnd(race.laps.segment[playerCar]);
+	float dx = next.x - x, dy = next.y - y;
+	out[OBS_WAYPOINT_AHEAD] = dx * vx + dy * vy;
+	out[OBS_WAYPOINT_LEFT] = dy * vx - dx * vy;
+	out[OBS_PROGRESS] = race.laps.distance[playerCar] / track.centreline().length();
+
+	castCarRays(track.grid(), cars, playerCar, 1, rayDirections, config.rayRange, out + OBS_RAYS);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+// many races stepped side by side, for training driving policies - each environment is
+// a race of its own with one car driven by the caller's actions, plus any cpu cars.
+// everything a caller reads back after a step is written into arrays allocated once up
+// front, each one contiguous across every environment, so a caller in another language
+// can wrap them as arrays and read them in place (see racegym.h for the C API)
+
+#include <memory>
+#include <vector>
+#include "simulation.h"
+
+class ThreadPool;
+
+struct VectorEnvConfig {
+	int envs = 16;
+	int cpuCars = 0;			// cpu cars in each race, alongside the agent's car
+	int rays = 16;				// wall distance sensors, fanned out across the front of the car
+	float rayRange = 30.0f;		// a ray that hits nothing reads as this far
+	float raySpread = 180.0f;	// degrees from the leftmost ray round to the rightmost
+	int ticksPerStep = 4;		// ticks each action is held for
+	long maxSteps = 20000;		// steps before an episode is cut short
+	int laps = 1;				// laps that finish an episode
+	int threads = 0;			// workers stepping the environments, 0 for one per core
+	unsigned seed = 1;			// every episode's grid is nudged by a seed taken from this
+};
+
+// what each environment's observation holds, in order - OBS_RAYS is the first of the
+// rays, from the leftmost to the rightmost, as distances to the nearest wall
+enum ObservationField {
+	OBS_X, OBS_Y,					// where the car is, in world units
+	OBS_HEADING_X, OBS_HEADING_Y,	// unit vector the car faces along
+	OBS_SPEED,						// as a fraction of top speed, 0 to 1
+	OBS_WAYPOINT_AHEAD,				// the next waypoint, in world units ahead of the car
+	OBS_WAYPOINT_LEFT,				// and to its left
+	OBS_PROGRESS,					// fraction of the lap done, negative before the start line
+	OBS_RAYS
+};
+
+class VectorEnv {
+public:
+	// the track is shared by every environment and has to outlive them
+	VectorEnv(const Track &track, const VectorEnvConfig &config);
+	~VectorEnv();
+
+	VectorEnv(const VectorEnv &) = delete;
+	VectorEnv &operator=(const VectorEnv &) = delete;
+
+	// starts a new episode in every environment and writes their first observations
+	void reset();
+
+	// holds each environment's action (CONTROL_ bits for its agent) for ticksPerStep ticks,
+	// then writes observations, rewards and whether each episode ended. an environment
+	// whose episode ended starts the next straight away, so its observation is the new
+	// episode's first
+	void step(const unsigned char *actions);
+
+	// episodes from here on end after laps, or are cut short after maxSteps
+	void setEpisode(int laps, long maxSteps) { config.laps = laps; config.maxSteps = maxSteps; }
+
+	int envs() const { return config.envs; }
+	int observationSize() const { return OBS_RAYS + config.rays; }
+
+	// envs() rows of observationSize() floats
+	const float *observations() const { return observationBuffer.data(); }
+
+	// units of track covered this step, forwards round the lap
+	const float *rewards() const { return rewardBuffer.data(); }
+
+	// the episode ended by finishing its laps, or was cut short at maxSteps
+	const unsigned char *terminated() const { return terminatedBuffer.data(); }
+	const unsigned char *truncated() const { return truncatedBuffer.data(); }
+
+	// steps taken since reset(), counting every environment
+	long long stepsTaken() const { return totalSteps; }
+
+private:
+	const Track &track;
+	VectorEnvConfig config;
+
+	std::vector<Race> races;
+	std::vector<long> steps;			// into each environment's episode
+	std::vector<long> episodes;			// started in each environment, for its seed
+	std::vector<float> covered;			// laps times lap length plus distance, at the last step
+	std::vector<point> rayDirections;	// each ray's direction with the car facing +y
+
+	std::vector<float> observationBuffer;
+	std::vector<float> rewardBuffer;
+	std::vector<unsigned char> terminatedBuffer, truncatedBuffer;
+	long long totalSteps = 0;
+
+	std::unique_ptr<ThreadPool> pool;	// null when stepping on the calling thread
+	int batches = 1;
+
+	void resetEnv(int env);
+	void stepEnv(int env, unsigned char action);
+	void observe(int env);
+	float coveredDistance(int env) const;
+
+	// runs body(env) for every environment, split across the pool
+	template <typename Body> void forEachEnv(Body body);
+};